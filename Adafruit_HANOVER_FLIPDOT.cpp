@@ -50,10 +50,263 @@
 #define pgm_read_byte(addr)                                                    \
   (*(const unsigned char *)(addr)) ///< PROGMEM workaround for non-AVR
 #endif
+#ifndef pgm_read_word
+#define pgm_read_word(addr)                                                    \
+  (*(const unsigned short *)(addr)) ///< PROGMEM workaround for non-AVR
+#endif
+#ifndef pgm_read_dword
+#define pgm_read_dword(addr)                                                   \
+  (*(const unsigned long *)(addr)) ///< PROGMEM workaround for non-AVR
+#endif
+#ifndef pgm_read_pointer
+#if !defined(__INT_MAX__) || (__INT_MAX__ > 0xFFFF)
+#define pgm_read_pointer(addr) ((void *)pgm_read_dword(addr)) ///< 32-bit ptr
+#else
+#define pgm_read_pointer(addr) ((void *)pgm_read_word(addr)) ///< 16-bit ptr
+#endif
+#endif
+
+#if (defined(__AVR__) || defined(ESP8266)) &&                                 \
+    !defined(HANOVER_FLIPDOT_PROGMEM_CHUNKS)
+#define HANOVER_FLIPDOT_PROGMEM_CHUNKS ///< PROGMEM is read with memcpy_P()
+#endif
+
+#define HANOVER_FLIPDOT_swap(a, b)                                             \
+  (((a) ^= (b)), ((b) ^= (a)), ((a) ^= (b))) ///< No-temp-var swap operation
 
 #include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Persist.h"
+#if !defined(ARDUINO)
+#include "HANOVER_FLIPDOT_Trace.h"
+#endif
 #include <Adafruit_GFX.h>
 
+// Bulk buffer operations work a machine word at a time; every operation
+// used is bitwise within a byte, so the byte order of the word is
+// irrelevant. 8-bit AVR gains nothing from wider words.
+#ifdef __AVR__
+typedef uint8_t HANOVER_FLIPDOT_word; ///< Native word for bulk operations
+#else
+typedef uint32_t HANOVER_FLIPDOT_word; ///< Native word for bulk operations
+#endif
+#define HANOVER_FLIPDOT_LANES(b)                                               \
+  ((HANOVER_FLIPDOT_word)0x01010101UL *                                        \
+   (uint8_t)(b)) ///< Byte value repeated in every byte of a word
+
+/*!
+    @brief  Load a word from a byte pointer of any alignment.
+    @param  p
+            Source address.
+    @return Word read.
+*/
+static inline HANOVER_FLIPDOT_word loadWord(const uint8_t *p) {
+  HANOVER_FLIPDOT_word w;
+  memcpy(&w, p, sizeof(w));
+  return w;
+}
+
+/*!
+    @brief  Store a word to a byte pointer of any alignment.
+    @param  p
+            Destination address.
+    @param  w
+            Word to write.
+*/
+static inline void storeWord(uint8_t *p, HANOVER_FLIPDOT_word w) {
+  memcpy(p, &w, sizeof(w));
+}
+
+/*!
+    @brief  Build each destination byte from the top bits of one source
+            byte and the bottom bits of another, i.e. a per-byte funnel
+            shift: dst[i] = (lo[i] >> k) | (hi[i] << (8 - k)).
+    @param  dst
+            Destination bytes. May be the same as lo or hi.
+    @param  lo
+            Source of the low bits of the result, or NULL for fill.
+    @param  hi
+            Source of the high bits of the result, or NULL for fill.
+    @param  fill
+            Byte used in place of a NULL source.
+    @param  n
+            Number of bytes.
+    @param  k
+            Shift, 1 to 7.
+*/
+static void funnelShift(uint8_t *dst, const uint8_t *lo, const uint8_t *hi,
+                        uint8_t fill, uint8_t n, uint8_t k) {
+  const HANOVER_FLIPDOT_word lo_mask = HANOVER_FLIPDOT_LANES(0xFF >> k);
+  const HANOVER_FLIPDOT_word hi_mask = ~lo_mask;
+  const HANOVER_FLIPDOT_word fill_w = HANOVER_FLIPDOT_LANES(fill);
+  uint8_t i = 0;
+  for (; i + sizeof(HANOVER_FLIPDOT_word) <= n;
+       i += sizeof(HANOVER_FLIPDOT_word)) {
+    HANOVER_FLIPDOT_word a = lo ? loadWord(lo + i) : fill_w;
+    HANOVER_FLIPDOT_word b = hi ? loadWord(hi + i) : fill_w;
+    storeWord(dst + i, ((a >> k) & lo_mask) | ((b << (8 - k)) & hi_mask));
+  }
+  for (; i < n; i++) {
+    uint8_t a = lo ? lo[i] : fill, b = hi ? hi[i] : fill;
+    dst[i] = (a >> k) | (b << (8 - k));
+  }
+}
+
+/*!
+    @brief  Combine a run of bytes into another with AND, OR or XOR.
+    @param  dst
+            Bytes to modify.
+    @param  src
+            Bytes to combine in (RAM).
+    @param  n
+            Number of bytes.
+    @param  op
+            HANOVER_FLIPDOT_OP_AND, HANOVER_FLIPDOT_OP_OR or
+            HANOVER_FLIPDOT_OP_XOR.
+*/
+static void combineBytes(uint8_t *dst, const uint8_t *src, uint16_t n,
+                         uint8_t op) {
+  uint16_t i = 0;
+  for (; i + sizeof(HANOVER_FLIPDOT_word) <= n;
+       i += sizeof(HANOVER_FLIPDOT_word)) {
+    HANOVER_FLIPDOT_word d = loadWord(dst + i), s = loadWord(src + i);
+    storeWord(dst + i, (op == HANOVER_FLIPDOT_OP_AND)  ? (d & s)
+                       : (op == HANOVER_FLIPDOT_OP_OR) ? (d | s)
+                                                       : (d ^ s));
+  }
+  for (; i < n; i++) {
+    dst[i] = (op == HANOVER_FLIPDOT_OP_AND)  ? (dst[i] & src[i])
+             : (op == HANOVER_FLIPDOT_OP_OR) ? (dst[i] | src[i])
+                                             : (dst[i] ^ src[i]);
+  }
+}
+
+/*!
+    @brief  AND, OR or XOR a run of bytes with the same mask byte.
+    @param  dst
+            Bytes to modify.
+    @param  mask
+            Mask byte.
+    @param  n
+            Number of bytes.
+    @param  op
+            HANOVER_FLIPDOT_OP_AND, HANOVER_FLIPDOT_OP_OR or
+            HANOVER_FLIPDOT_OP_XOR.
+*/
+static void maskBytes(uint8_t *dst, uint8_t mask, uint8_t n, uint8_t op) {
+  const HANOVER_FLIPDOT_word m = HANOVER_FLIPDOT_LANES(mask);
+  uint8_t i = 0;
+  for (; i + sizeof(HANOVER_FLIPDOT_word) <= n;
+       i += sizeof(HANOVER_FLIPDOT_word)) {
+    HANOVER_FLIPDOT_word d = loadWord(dst + i);
+    storeWord(dst + i, (op == HANOVER_FLIPDOT_OP_AND)  ? (d & m)
+                       : (op == HANOVER_FLIPDOT_OP_OR) ? (d | m)
+                                                       : (d ^ m));
+  }
+  for (; i < n; i++) {
+    dst[i] = (op == HANOVER_FLIPDOT_OP_AND)  ? (dst[i] & mask)
+             : (op == HANOVER_FLIPDOT_OP_OR) ? (dst[i] | mask)
+                                             : (dst[i] ^ mask);
+  }
+}
+
+/*!
+    @brief  OR together the differences between two runs of bytes.
+    @param  a
+            First run (e.g. buffer).
+    @param  b
+            Second run (e.g. shadow).
+    @param  inv
+            0x00, or 0xFF to compare a against the inverse of b.
+    @param  n
+            Number of bytes.
+    @return Byte with a bit set for every row that differs in any column,
+            0 if the runs match.
+*/
+static uint8_t diffBytes(const uint8_t *a, const uint8_t *b, uint8_t inv,
+                         uint8_t n) {
+  const HANOVER_FLIPDOT_word m = HANOVER_FLIPDOT_LANES(inv);
+  HANOVER_FLIPDOT_word acc = 0;
+  uint8_t i = 0;
+  for (; i + sizeof(HANOVER_FLIPDOT_word) <= n;
+       i += sizeof(HANOVER_FLIPDOT_word))
+    acc |= loadWord(a + i) ^ loadWord(b + i) ^ m;
+  uint8_t d = 0;
+  for (uint8_t j = 0; j < sizeof(HANOVER_FLIPDOT_word); j++, acc >>= 8)
+    d |= (uint8_t)acc;
+  for (; i < n; i++)
+    d |= a[i] ^ b[i] ^ inv;
+  return d;
+}
+
+/*!
+    @brief  OR together a run of bytes, a machine word at a time.
+    @param  a
+            Run of bytes (e.g. part of a page of the unknown map).
+    @param  n
+            Number of bytes.
+    @return Byte with a bit set for every row set in any column.
+*/
+static uint8_t orBytes(const uint8_t *a, uint8_t n) {
+  HANOVER_FLIPDOT_word acc = 0;
+  uint8_t i = 0;
+  for (; i + sizeof(HANOVER_FLIPDOT_word) <= n;
+       i += sizeof(HANOVER_FLIPDOT_word))
+    acc |= loadWord(a + i);
+  uint8_t d = 0;
+  for (uint8_t j = 0; j < sizeof(HANOVER_FLIPDOT_word); j++, acc >>= 8)
+    d |= (uint8_t)acc;
+  for (; i < n; i++)
+    d |= a[i];
+  return d;
+}
+
+/*!
+    @brief  Raise an atomic request level to at least a given value.
+    @param  level
+            Level to raise.
+    @param  v
+            Minimum value.
+    @return None (void).
+*/
+static void raiseLevel(uint8_t *level, uint8_t v) {
+  uint8_t cur = __atomic_load_n(level, __ATOMIC_RELAXED);
+  while ((cur < v) && !__atomic_compare_exchange_n(level, &cur, v, true,
+                                                   __ATOMIC_RELEASE,
+                                                   __ATOMIC_RELAXED))
+    ;
+}
+
+/*!
+    @brief  CRC-16/CCITT (polynomial 0x1021, MSB first) of a run of bytes.
+    @param  data
+            Bytes to check.
+    @param  n
+            Number of bytes.
+    @param  crc
+            Initial value, or the result of a previous call to continue a
+            CRC over several runs. Default if unspecified is 0xFFFF.
+    @return Updated CRC.
+*/
+uint16_t HANOVER_FLIPDOT_crc16(const uint8_t *data, uint16_t n, uint16_t crc) {
+  while (n--) {
+    crc ^= (uint16_t)*data++ << 8;
+    for (uint8_t b = 0; b < 8; b++)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+Adafruit_HANOVER_FLIPDOT *Adafruit_HANOVER_FLIPDOT::selected = NULL;
+
+#if HANOVER_FLIPDOT_TRACE_RING
+static_assert(!(HANOVER_FLIPDOT_TRACE_RING & (HANOVER_FLIPDOT_TRACE_RING - 1)),
+              "HANOVER_FLIPDOT_TRACE_RING must be a power of 2");
+HANOVER_FLIPDOT_TraceEvent
+    Adafruit_HANOVER_FLIPDOT::trace_ring[HANOVER_FLIPDOT_TRACE_RING];
+uint16_t Adafruit_HANOVER_FLIPDOT::trace_head = 0;
+uint16_t Adafruit_HANOVER_FLIPDOT::trace_tail = 0;
+#endif
+
 // CONSTRUCTORS, DESTRUCTOR ------------------------------------------------
 
 /*!
@@ -89,50 +342,120 @@
     The list of members to be initialized is indicated with a constructor as 
     a comma-separated list followed by a colon.
 */
-Adafruit_HANOVER_FLIPDOT::Adafruit_HANOVER_FLIPDOT(uint8_t w, uint8_t h, int8_t reset_pin, int8_t row_adv_pin, int8_t col_adv_pin, int8_t coil_pulse_pin, int8_t set_pin, int8_t disp1_enable_pin, int8_t disp2_enable_pin, int8_t disp3_enable_pin, int8_t disp4_enable_pin): Adafruit_GFX(w, h), buffer(NULL), reset_pin(reset_pin), row_adv_pin(row_adv_pin), col_adv_pin(col_adv_pin), coil_pulse_pin(coil_pulse_pin), set_pin(set_pin), disp1_enable_pin(disp1_enable_pin), disp2_enable_pin(disp2_enable_pin), disp3_enable_pin(disp3_enable_pin), disp4_enable_pin(disp4_enable_pin) 
+Adafruit_HANOVER_FLIPDOT::Adafruit_HANOVER_FLIPDOT(uint8_t w, uint8_t h, int8_t reset_pin, int8_t row_adv_pin, int8_t col_adv_pin, int8_t coil_pulse_pin, int8_t set_pin, int8_t disp1_enable_pin, int8_t disp2_enable_pin, int8_t disp3_enable_pin, int8_t disp4_enable_pin): Adafruit_GFX(w, h), buffer(NULL), shadow(NULL), cow_pool(NULL), cow_slots(0), cow_used(0), cow_active(0), refresh_page(0),
+      preempt(0), scan_level(0xFF), scanning(0), refresh_us(0),
+      timing(HANOVER_FLIPDOT_TIMING_DEFAULT),
+      checkpoint_every(0), since_reset(0), seg_lo(0xFF), seg_hi(0),
+      wear(NULL), wear_grouped(false), total_pulses(0),
+      touched(NULL), exercise_rate(0), exercise_tokens(0), exercise_ms(0),
+      exercise_x(0), exercise_y(0), exercising(false), render(NULL), render_ctx(NULL), render_page(NULL), render_state(0), render_inv(0), render_blank(true), render_unknown(false), unknown(NULL), persist(NULL), persisted(0), invert_mask(0), panel_idx(1), reset_pin(reset_pin), row_adv_pin(row_adv_pin), col_adv_pin(col_adv_pin), coil_pulse_pin(coil_pulse_pin), set_pin(set_pin), disp1_enable_pin(disp1_enable_pin), disp2_enable_pin(disp2_enable_pin), disp3_enable_pin(disp3_enable_pin), disp4_enable_pin(disp4_enable_pin) {
+  frames[0] = frames[1] = frames[2] = NULL;
+#if !defined(ARDUINO)
+  trace = NULL;
+#endif
+  clearTextCache();
+}
 
 /*!
     @brief  Destructor for Adafruit_HANOVER_FLIPDOT object.
 */
 Adafruit_HANOVER_FLIPDOT::~Adafruit_HANOVER_FLIPDOT(void) {
+  if (frames[1]) { // Triple buffering: buffer is one of frames[]
+    for (uint8_t i = 0; i < 3; i++)
+      free(frames[i]);
+    buffer = NULL;
+  }
   if (buffer) {
     free(buffer);
     buffer = NULL;
   }
+  if (shadow) {
+    free(shadow);
+    shadow = NULL;
+  }
+  if (cow_pool) {
+    free(cow_pool);
+    cow_pool = NULL;
+  }
+  if (unknown) {
+    free(unknown);
+    unknown = NULL;
+  }
+  if (wear) {
+    free(wear);
+    wear = NULL;
+  }
+  if (touched) {
+    free(touched);
+    touched = NULL;
+  }
+  if (render_page) {
+    free(render_page);
+    render_page = NULL;
+  }
+  if (selected == this)
+    selected = NULL;
+}
+
+/*!
+    @brief  Drive a control line, through an attached trace on host builds.
+    @param  pin
+            Pin to drive.
+    @param  value
+            HIGH or LOW.
+    @return None (void).
+*/
+inline void Adafruit_HANOVER_FLIPDOT::pinWrite(int8_t pin, uint8_t value) {
+#if !defined(ARDUINO)
+  if (trace)
+    trace->pin(pin, value);
+#endif
+  digitalWrite(pin, value);
 }
 
 // ALLOCATE & INIT DISPLAY -------------------------------------------------
 
 /*!
     @brief  Allocate RAM for image buffer, initialize peripherals and pins.
-    @param  addr
-            I2C address of corresponding HANOVER_FLIPDOT display (or pass 0 to use
-            default of 0x3C for 128x32 display, 0x3D for all others).
-            SPI displays (hardware or software) do not use addresses, but
-            this argument is still required (pass 0 or any value really,
-            it will simply be ignored). Default if unspecified is 0.
     @param  reset
             If true, and if the reset pin passed to the constructor is
             valid, a hard reset will be performed before initializing the
-            display. If using multiple HANOVER_FLIPDOT displays on the same bus, and
-            if they all share the same reset pin, you should only pass true
-            on the first display being initialized, false on all others,
-            else the already-initialized displays would be reset. Default if
-            unspecified is true.
+            display. If several panels share the same reset pin, you should
+            only pass true on the first panel being initialized, false on
+            all others. Default if unspecified is true.
+    @param  display_idx
+            Which enable pin (1 to 4) selects this panel. Default if
+            unspecified is 1.
+    @param  wipe
+            If true, drive every dot yellow and then black right away.
+            Otherwise (the default) every dot is only marked unknown and
+            the first display() drives each one once, to its buffer state.
     @return true on successful allocation/init, false otherwise.
             Well-behaved code should check the return value before
             proceeding.
-    @note   MUST call this function before any drawing or updates!
+    @note   MUST call this function before any drawing or updates! With a
+            valid state restored by HANOVER_FLIPDOT_Persist, no dot is
+            driven either way.
 */
-bool Adafruit_HANOVER_FLIPDOT::begin(bool reset, uint8_t display_idx) {
-  // Note: we have put in place the means to specify a display_idx, but there
-  // may not be enough mem to actually buffer all of them separately.
-  // Additionally, we dont have safe pin disabling, so just set display 1 for now.
-
-  if ((!buffer) && !(buffer = (uint8_t *)malloc(WIDTH * ((HEIGHT + 7) / 8))))
-    return false;
+bool Adafruit_HANOVER_FLIPDOT::begin(bool reset, uint8_t display_idx,
+                                     bool wipe) {
+  // Note: each panel of a multi-panel sign is its own object with its own
+  // buffer, selected through its enable pin whenever it is driven. See
+  // HANOVER_FLIPDOT_Tiled to draw across them as one surface.
 
-  clearDisplay();
+  if (render) {
+    // Streaming mode: no buffer or shadow, just a page rendered twice
+    if ((!render_page) && !(render_page = (uint8_t *)malloc(2 * WIDTH)))
+      return false;
+  } else {
+    if ((!buffer) &&
+        !(buffer = (uint8_t *)malloc(WIDTH * ((HEIGHT + 7) / 8))))
+      return false;
+    if ((!shadow) &&
+        !(shadow = (uint8_t *)malloc(WIDTH * ((HEIGHT + 7) / 8))))
+      return false;
+    clearDisplay();
+  }
 
   // Setup pin directions
   
@@ -140,41 +463,81 @@ bool Adafruit_HANOVER_FLIPDOT::begin(bool reset, uint8_t display_idx) {
   pinMode(col_adv_pin, OUTPUT);        ///< The pin used to advance the col. Set during construction.
   pinMode(coil_pulse_pin, OUTPUT);     ///< Used to provide drive power to change the dot state. Set during construction.
   pinMode(set_pin, OUTPUT);            ///< Used to select which way the current will be pulsed. Set during construction.
-  pinMode(disp1_enable_pin, OUTPUT);   ///< The pin used to select display 1. Set during construction.
-  pinMode(disp2_enable_pin, OUTPUT);   ///< The pin used to select display 2. Set during construction.
-  pinMode(disp3_enable_pin, OUTPUT);   ///< The pin used to select display 3. Set during construction.
-  pinMode(disp4_enable_pin, OUTPUT);   ///< The pin used to select display 4. Set during construction.
+  if (reset_pin >= 0)
+    pinMode(reset_pin, OUTPUT);        ///< The pin used to reset both row and col binary counters. Set during construction.
+  if (disp1_enable_pin >= 0)
+    pinMode(disp1_enable_pin, OUTPUT); ///< The pin used to select display 1. Set during construction.
+  if (disp2_enable_pin >= 0)
+    pinMode(disp2_enable_pin, OUTPUT); ///< The pin used to select display 2. Set during construction.
+  if (disp3_enable_pin >= 0)
+    pinMode(disp3_enable_pin, OUTPUT); ///< The pin used to select display 3. Set during construction.
+  if (disp4_enable_pin >= 0)
+    pinMode(disp4_enable_pin, OUTPUT); ///< The pin used to select display 4. Set during construction.
 
   // Set the enable pin high for the display.
-  switch(display_idx){
-    case 1 : 
-      digitalWrite(disp1_enable_pin, HIGH);
-    case 2 : 
-      digitalWrite(disp2_enable_pin, HIGH); 
-    case 3 : 
-      digitalWrite(disp3_enable_pin, HIGH); 
-    case 4 : 
-      digitalWrite(disp4_enable_pin, HIGH);  
-  }
+  panel_idx = display_idx;
+  selected = NULL;
+  selectPanel();
 
   // Reset HANOVER_FLIPDOT if requested and reset pin specified in constructor
   if (reset && (reset_pin >= 0)) {
-    pinMode(reset_pin, OUTPUT);        ///< The pin used to reset both row and col binary counters. Set during construction.
-    digitalWrite(reset_pin, HIGH);
-    delay(1);                          // VDD goes high at start, pause for 1 ms
-    digitalWrite(reset_pin, LOW);      // Bring reset low
-    delay(10);                         // Wait 10 ms
-    digitalWrite(reset_pin, HIGH);     // Bring out of reset
-    uint8_t col_idx = 0; // reset column index
-    uint8_t row_idx = 0; // reset row index
+    pinWrite(reset_pin, HIGH);
+    wait(timing.boot_us);              // VDD goes high at start, pause
+    pinWrite(reset_pin, LOW);          // Bring reset low
+    wait(timing.boot_reset_us);        // Hold
+    pinWrite(reset_pin, HIGH);         // Bring out of reset
   }
+  col_idx = 0; // reset column index
+  row_idx = 0; // reset row index
+  since_reset = 0;
 
   // Init sequence
-  // insert some drawPixel stuff to show things happend.
+  // The panel may power up showing anything, so unless a valid saved state
+  // says what it shows, every dot is unknown. Marking them so costs one
+  // pulse per dot on the first refresh instead of two here; the sweep is
+  // kept for callers that ask for it (or if the map can't be allocated).
+  persisted = 0;
+  render_blank = true;
+  render_unknown = false;
+  if (render) {
+    if (wipe) {
+      sweep(true);
+      sweep(false);
+    } else {
+      render_unknown = true;
+    }
+  } else if (!persist || !persist->load()) {
+    memset(shadow, 0, WIDTH * ((HEIGHT + 7) / 8));
+    if (wipe || !markUnknown(0, 0, WIDTH, HEIGHT)) {
+      sweep(true);
+      sweep(false);
+    }
+  }
 
   return true; // Success
 }
 
+/*!
+    @brief  Set the drive timing for this panel.
+    @param  t
+            Timing profile, e.g. HANOVER_FLIPDOT_TIMING_DEFAULT or
+            HANOVER_FLIPDOT_TIMING_FAST. Copied, so a temporary is fine.
+    @return None (void).
+    @note   Call before begin() for the boot timing to apply. Each panel
+            of a tiled sign has its own profile.
+*/
+void Adafruit_HANOVER_FLIPDOT::setTiming(const HANOVER_FLIPDOT_Timing &t) {
+  timing = t;
+}
+
+/*!
+    @brief  Get the drive timing in use.
+    @return Reference to the panel's timing profile.
+*/
+const HANOVER_FLIPDOT_Timing &Adafruit_HANOVER_FLIPDOT::getTiming(void) {
+  return timing;
+}
+
 // DRAWING FUNCTIONS -------------------------------------------------------
 
 /*!
@@ -194,6 +557,7 @@ bool Adafruit_HANOVER_FLIPDOT::begin(bool reset, uint8_t display_idx) {
             commands as needed by one's own application.
 */
 void Adafruit_HANOVER_FLIPDOT::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  HANOVER_FLIPDOT_TRACE(HANOVER_FLIPDOT_EV_PIXEL, x, y);
   if ((x >= 0) && (x < width()) && (y >= 0) && (y < height())) {
     // Pixel is in-bounds. Rotate coordinates if needed.
     switch (getRotation()) {
@@ -210,15 +574,16 @@ void Adafruit_HANOVER_FLIPDOT::drawPixel(int16_t x, int16_t y, uint16_t color) {
       y = HEIGHT - y - 1;
       break;
     }
+    uint8_t *page = writablePage(y / 8);
     switch (color) {
     case HANOVER_FLIPDOT_YELLOW:
-      buffer[x + (y / 8) * WIDTH] |= (1 << (y & 7));
+      page[x] |= (1 << (y & 7));
       break;
     case HANOVER_FLIPDOT_BLACK:
-      buffer[x + (y / 8) * WIDTH] &= ~(1 << (y & 7));
+      page[x] &= ~(1 << (y & 7));
       break;
     case HANOVER_FLIPDOT_INVERSE:
-      buffer[x + (y / 8) * WIDTH] ^= (1 << (y & 7));
+      page[x] ^= (1 << (y & 7));
       break;
     }
   }
@@ -232,7 +597,9 @@ void Adafruit_HANOVER_FLIPDOT::drawPixel(int16_t x, int16_t y, uint16_t color) {
             commands as needed by one's own application.
 */
 void Adafruit_HANOVER_FLIPDOT::clearDisplay(void) {
-  memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+  HANOVER_FLIPDOT_TRACE(HANOVER_FLIPDOT_EV_CLEAR, 0, 0);
+  for (uint8_t p = 0; p < (HEIGHT + 7) / 8; p++)
+    memset(writablePage(p), 0, WIDTH);
 }
 
 /*!
@@ -263,7 +630,8 @@ bool Adafruit_HANOVER_FLIPDOT::getPixel(int16_t x, int16_t y) {
       y = HEIGHT - y - 1;
       break;
     }
-    return (buffer[x + (y / 8) * WIDTH] & (1 << (y & 7)));
+    const uint8_t *page = readablePage(y / 8);
+    return (page[x] & (1 << (y & 7)));
   }
   return false; // Pixel out of bounds
 }
@@ -272,58 +640,1574 @@ bool Adafruit_HANOVER_FLIPDOT::getPixel(int16_t x, int16_t y) {
     @brief  Get base address of display buffer for direct reading or writing.
     @return Pointer to an unsigned 8-bit array, column-major, columns padded
             to full byte boundary if needed.
+    @note   Folds back any copy-on-write page copies first, so do not call
+            while a requestDisplay() refresh is in flight.
 */
-uint8_t *Adafruit_HANOVER_FLIPDOT::getBuffer(void) { return buffer; }
+uint8_t *Adafruit_HANOVER_FLIPDOT::getBuffer(void) {
+  commitPages();
+  return buffer;
+}
 
-// REFRESH DISPLAY ---------------------------------------------------------
-/*
-************************************
-************************************
-************************************
-************************************
-CHANGE THIS!!!!!!
-************************************
-************************************
-************************************
-************************************
+// BUFFER OPERATIONS -------------------------------------------------------
+
+/*!
+    @brief  Clip a rectangle to the unrotated panel.
+    @param  x
+            Pointer to left column, updated.
+    @param  y
+            Pointer to top row, updated.
+    @param  w
+            Pointer to width, updated.
+    @param  h
+            Pointer to height, updated.
+    @return true if anything of the rectangle is left, false otherwise.
+*/
+bool Adafruit_HANOVER_FLIPDOT::clipRegion(int16_t *x, int16_t *y, int16_t *w,
+                                          int16_t *h) {
+  if (*x < 0) {
+    *w += *x;
+    *x = 0;
+  }
+  if (*y < 0) {
+    *h += *y;
+    *y = 0;
+  }
+  if (*x + *w > WIDTH)
+    *w = WIDTH - *x;
+  if (*y + *h > HEIGHT)
+    *h = HEIGHT - *y;
+  return (*w > 0) && (*h > 0);
+}
+
+/*!
+    @brief  Get the rows of a page that are on the panel.
+    @param  page
+            Page (band of 8 rows) index.
+    @return 0xFF, or for a last page that HEIGHT does not fill, a mask of
+            the rows that exist.
+*/
+uint8_t Adafruit_HANOVER_FLIPDOT::pageRows(uint8_t page) {
+  if ((page == HEIGHT / 8) && (HEIGHT & 7))
+    return 0xFF >> (8 - (HEIGHT & 7));
+  return 0xFF;
+}
+
+/*!
+    @brief  Clear the unused bits of the last page when HEIGHT is not a
+            multiple of 8, so bulk operations never carry them into view.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::clearPadding(void) {
+  if (HEIGHT & 7)
+    maskBytes(writablePage(HEIGHT / 8), pageRows(HEIGHT / 8), WIDTH,
+              HANOVER_FLIPDOT_OP_AND);
+}
+
+/*!
+    @brief  Move the whole buffer up, filling the rows exposed at the
+            bottom.
+    @param  n
+            Number of rows to shift.
+    @param  color
+            HANOVER_FLIPDOT_BLACK or HANOVER_FLIPDOT_YELLOW fill.
+    @return None (void).
+    @note   Like all bulk operations this works on the unrotated panel and
+            changes buffer contents only; follow up with display().
+*/
+void Adafruit_HANOVER_FLIPDOT::shiftUp(uint8_t n, uint16_t color) {
+  uint8_t fill = (color == HANOVER_FLIPDOT_YELLOW) ? 0xFF : 0x00;
+  uint8_t pages = (HEIGHT + 7) / 8, q = n / 8, k = n & 7;
+  if (HEIGHT & 7) // Rows past HEIGHT must shift in as fill
+    maskBytes(writablePage(pages - 1),
+              fill ? (0xFF << (HEIGHT & 7)) : (0xFF >> (8 - (HEIGHT & 7))),
+              WIDTH, fill ? HANOVER_FLIPDOT_OP_OR : HANOVER_FLIPDOT_OP_AND);
+  for (uint8_t p = 0; p < pages; p++) {
+    uint8_t *dst = writablePage(p); // Before the reads: it may fold copies
+    const uint8_t *lo = (p + q < pages) ? readablePage(p + q) : NULL;
+    const uint8_t *hi = (p + q + 1 < pages) ? readablePage(p + q + 1) : NULL;
+    if (k)
+      funnelShift(dst, lo, hi, fill, WIDTH, k);
+    else if (lo)
+      memmove(dst, lo, WIDTH);
+    else
+      memset(dst, fill, WIDTH);
+  }
+  clearPadding();
+}
+/*!
+    @brief  Move the whole buffer down, filling the rows exposed at the
+            top.
+    @param  n
+            Number of rows to shift.
+    @param  color
+            HANOVER_FLIPDOT_BLACK or HANOVER_FLIPDOT_YELLOW fill.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::shiftDown(uint8_t n, uint16_t color) {
+  uint8_t fill = (color == HANOVER_FLIPDOT_YELLOW) ? 0xFF : 0x00;
+  uint8_t pages = (HEIGHT + 7) / 8, q = n / 8, k = n & 7;
+  for (int16_t p = pages - 1; p >= 0; p--) {
+    uint8_t *dst = writablePage(p); // Before the reads: it may fold copies
+    const uint8_t *hi = (p - q >= 0) ? readablePage(p - q) : NULL;
+    const uint8_t *lo = (p - q - 1 >= 0) ? readablePage(p - q - 1) : NULL;
+    if (k)
+      funnelShift(dst, lo, hi, fill, WIDTH, 8 - k);
+    else if (hi)
+      memmove(dst, hi, WIDTH);
+    else
+      memset(dst, fill, WIDTH);
+  }
+  clearPadding();
+}
+
+/*!
+    @brief  Move the whole buffer left, filling the columns exposed at the
+            right.
+    @param  n
+            Number of columns to shift.
+    @param  color
+            HANOVER_FLIPDOT_BLACK or HANOVER_FLIPDOT_YELLOW fill.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::shiftLeft(uint8_t n, uint16_t color) {
+  uint8_t fill = (color == HANOVER_FLIPDOT_YELLOW) ? 0xFF : 0x00;
+  if (n > WIDTH)
+    n = WIDTH;
+  for (uint8_t p = 0; p < (HEIGHT + 7) / 8; p++) {
+    uint8_t *row = writablePage(p);
+    memmove(row, row + n, WIDTH - n);
+    memset(row + WIDTH - n, fill, n);
+  }
+  clearPadding();
+}
+
+/*!
+    @brief  Move the whole buffer right, filling the columns exposed at the
+            left.
+    @param  n
+            Number of columns to shift.
+    @param  color
+            HANOVER_FLIPDOT_BLACK or HANOVER_FLIPDOT_YELLOW fill.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::shiftRight(uint8_t n, uint16_t color) {
+  uint8_t fill = (color == HANOVER_FLIPDOT_YELLOW) ? 0xFF : 0x00;
+  if (n > WIDTH)
+    n = WIDTH;
+  for (uint8_t p = 0; p < (HEIGHT + 7) / 8; p++) {
+    uint8_t *row = writablePage(p);
+    memmove(row + n, row, WIDTH - n);
+    memset(row, fill, n);
+  }
+  clearPadding();
+}
+
+/*!
+    @brief  Clear every dot outside a rectangle, keeping only its inside.
+    @param  x
+            Left column of the rectangle, unrotated.
+    @param  y
+            Top row of the rectangle, unrotated.
+    @param  w
+            Width of the rectangle.
+    @param  h
+            Height of the rectangle.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::maskRegion(int16_t x, int16_t y, int16_t w,
+                                          int16_t h) {
+  if (!clipRegion(&x, &y, &w, &h)) {
+    clearDisplay();
+    return;
+  }
+  int16_t y1 = y + h - 1;
+  for (uint8_t p = 0; p < (HEIGHT + 7) / 8; p++) {
+    uint8_t *row = writablePage(p);
+    uint8_t keep = 0;
+    if ((p >= y / 8) && (p <= y1 / 8)) {
+      keep = 0xFF;
+      if (p == y / 8)
+        keep &= 0xFF << (y & 7);
+      if (p == y1 / 8)
+        keep &= 0xFF >> (7 - (y1 & 7));
+    }
+    memset(row, 0, x);
+    maskBytes(row + x, keep, w, HANOVER_FLIPDOT_OP_AND);
+    memset(row + x + w, 0, WIDTH - x - w);
+  }
+}
+
+/*!
+    @brief  Invert every dot inside a rectangle, a whole byte (8 rows) at a
+            time wherever the rectangle covers a full page.
+    @param  x
+            Left column of the rectangle, unrotated.
+    @param  y
+            Top row of the rectangle, unrotated.
+    @param  w
+            Width of the rectangle.
+    @param  h
+            Height of the rectangle.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::invertRegion(int16_t x, int16_t y, int16_t w,
+                                            int16_t h) {
+  if (!clipRegion(&x, &y, &w, &h))
+    return;
+  int16_t y1 = y + h - 1;
+  for (uint8_t p = y / 8; p <= y1 / 8; p++) {
+    uint8_t flip = 0xFF;
+    if (p == y / 8)
+      flip &= 0xFF << (y & 7);
+    if (p == y1 / 8)
+      flip &= 0xFF >> (7 - (y1 & 7));
+    maskBytes(writablePage(p) + x, flip, w, HANOVER_FLIPDOT_OP_XOR);
+  }
+}
+
+/*!
+    @brief  Combine another frame into the buffer with AND, OR or XOR.
+    @param  src
+            Frame in RAM, in the same page-major layout and size as
+            getBuffer().
+    @param  op
+            HANOVER_FLIPDOT_OP_AND, HANOVER_FLIPDOT_OP_OR or
+            HANOVER_FLIPDOT_OP_XOR.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::combineBuffer(const uint8_t *src, uint8_t op) {
+  for (uint8_t p = 0; p < (HEIGHT + 7) / 8; p++)
+    combineBytes(writablePage(p), &src[p * WIDTH], WIDTH, op);
+  clearPadding();
+}
+
+/*!
+    @brief  Combine a frame stored in PROGMEM into the buffer with AND, OR
+            or XOR.
+    @param  bitmap
+            PROGMEM frame in the same page-major layout and size as
+            getBuffer().
+    @param  op
+            HANOVER_FLIPDOT_OP_AND, HANOVER_FLIPDOT_OP_OR or
+            HANOVER_FLIPDOT_OP_XOR.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::combineBitmap(const uint8_t *bitmap,
+                                             uint8_t op) {
+#ifdef HANOVER_FLIPDOT_PROGMEM_CHUNKS
+  // Flash can't be read like RAM here; bring it over a chunk at a time.
+  // 16-bit: past a WIDTH of 224 the last step would wrap a uint8_t.
+  uint8_t chunk[32];
+  for (uint8_t p = 0; p < (HEIGHT + 7) / 8; p++) {
+    for (uint16_t i = 0; i < WIDTH; i += sizeof(chunk)) {
+      uint16_t k = WIDTH - i;
+      if (k > sizeof(chunk))
+        k = sizeof(chunk);
+      memcpy_P(chunk, &bitmap[p * WIDTH + i], k);
+      combineBytes(writablePage(p) + i, chunk, k, op);
+    }
+  }
+  clearPadding();
+#else
+  combineBuffer(bitmap, op); // PROGMEM is ordinary addressable memory here
+#endif
+}
+
+// TRIPLE BUFFERING --------------------------------------------------------
+
+// The shared slot and a "fresh" flag live in one byte so each handoff is a
+// single atomic exchange. The drawing side owns back_idx and the refresh
+// side owns front_idx; neither is touched by the other.
+#define HANOVER_FLIPDOT_SLOT_MASK 0x03 ///< Frame index part of handoff
+#define HANOVER_FLIPDOT_FRESH 0x04     ///< handoff slot not yet displayed
+
+/*!
+    @brief  Allocate two more frame buffers so drawing and refreshing can
+            run concurrently (e.g. refresh from a timer ISR or another core).
+    @return true on successful allocation, false otherwise.
+    @note   Call after begin(). From then on the drawing side draws into
+            getBuffer() and calls commitFrame(); the refresh side calls
+            displayLatest(). display() should no longer be used, since it
+            would touch the panel from the drawing side.
+*/
+bool Adafruit_HANOVER_FLIPDOT::enableTripleBuffering(void) {
+  if (frames[1])
+    return true;
+  if (!buffer)
+    return false;
+  uint16_t size = WIDTH * ((HEIGHT + 7) / 8);
+  frames[1] = (uint8_t *)malloc(size);
+  frames[2] = (uint8_t *)malloc(size);
+  if (!frames[1] || !frames[2]) {
+    free(frames[1]);
+    free(frames[2]);
+    frames[1] = frames[2] = NULL;
+    return false;
+  }
+  memcpy(frames[1], shadow, size); // Nothing fresh yet, but keep the
+  memcpy(frames[2], shadow, size); // refresh side's view consistent
+  frames[0] = buffer;
+  back_idx = 0;
+  front_idx = 2;
+  __atomic_store_n(&handoff, 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+/*!
+    @brief  Hand the finished back buffer to the refresh side and continue
+            drawing into a free one. Never blocks and never copies: if the
+            previous frame was not picked up yet it is simply replaced.
+    @param  priority
+            Urgency of the frame. If higher than that of the frame being
+            refreshed, displayLatest() abandons it at the next dot and
+            switches to this one. Default if unspecified is 0.
+    @return None (void).
+    @note   The new back buffer holds an older frame, not the one just
+            committed. Redraw the whole frame (or clearDisplay() first)
+            before the next commit.
+*/
+void Adafruit_HANOVER_FLIPDOT::commitFrame(uint8_t priority) {
+  if (!frames[1])
+    return;
+  commitPages(); // Copies belong to this frame, not the next back buffer
+  uint8_t old = __atomic_exchange_n(
+      &handoff, (uint8_t)(back_idx | HANOVER_FLIPDOT_FRESH), __ATOMIC_ACQ_REL);
+  back_idx = old & HANOVER_FLIPDOT_SLOT_MASK;
+  buffer = frames[back_idx];
+  raiseLevel(&preempt, (priority < 0xFE) ? priority + 1 : 0xFE);
+}
+
+/*!
+    @brief  Refresh the panel to the most recently committed frame, if one
+            has been committed since the last call. Frames committed in
+            between are skipped.
+    @return true if a new frame was taken and displayed, false if there
+            was nothing new.
+    @note   Safe to run concurrently with drawing and commitFrame(), but
+            only ever from one refresh context at a time. A more urgent
+            commit arriving mid-refresh is switched to at once; the dots
+            already flipped count, so only what still differs is pulsed.
+*/
+bool Adafruit_HANOVER_FLIPDOT::displayLatest(void) {
+  if (!frames[1] ||
+      !(__atomic_load_n(&handoff, __ATOMIC_ACQUIRE) & HANOVER_FLIPDOT_FRESH))
+    return false;
+  uint8_t old = __atomic_exchange_n(&handoff, front_idx, __ATOMIC_ACQ_REL);
+  front_idx = old & HANOVER_FLIPDOT_SLOT_MASK;
+  uint32_t start = micros();
+  for (;;) {
+    scan_level = __atomic_exchange_n(&preempt, 0, __ATOMIC_ACQ_REL);
+    if (refresh(frames[front_idx], 0, 0, WIDTH - 1, HEIGHT - 1))
+      break;
+    // Preempted by a more urgent commit; switch to it
+    if (__atomic_load_n(&handoff, __ATOMIC_ACQUIRE) & HANOVER_FLIPDOT_FRESH) {
+      old = __atomic_exchange_n(&handoff, front_idx, __ATOMIC_ACQ_REL);
+      front_idx = old & HANOVER_FLIPDOT_SLOT_MASK;
+    }
+  }
+  scan_level = 0xFF;
+  timeRefresh(start);
+  return true;
+}
+
+// WEAR TELEMETRY ----------------------------------------------------------
+
+/*!
+    @brief  Start counting coil pulses per dot, to spot coils nearing the
+            end of their life and to check that diff refresh and content
+            moves actually spread the wear.
+    @param  grouped
+            If true, count per 8-dot page column (one counter per buffer
+            byte, 1/8 of the RAM) instead of per dot.
+    @return true on successful allocation (or if already enabled), false
+            otherwise.
+    @note   Counters are 32-bit and start at 0; restore saved values
+            through getWearTable(). getTotalPulses() counts regardless.
+*/
+bool Adafruit_HANOVER_FLIPDOT::enableWearTracking(bool grouped) {
+  if (wear)
+    return true;
+  uint16_t n = grouped ? WIDTH * ((HEIGHT + 7) / 8) : WIDTH * HEIGHT;
+  if (!(wear = (uint32_t *)calloc(n, sizeof(uint32_t))))
+    return false;
+  wear_grouped = grouped;
+  return true;
+}
+
+/*!
+    @brief  Get the coil pulses counted for a dot.
+    @param  x
+            Column, unrotated.
+    @param  y
+            Row, unrotated.
+    @return Pulses for the dot, or for its 8-dot group when grouped. 0 if
+            out of range or not tracking.
+*/
+uint32_t Adafruit_HANOVER_FLIPDOT::getWear(uint8_t x, uint8_t y) {
+  if (!wear || (x >= WIDTH) || (y >= HEIGHT))
+    return 0;
+  return wear[wear_grouped ? x + (y / 8) * WIDTH : x + y * WIDTH];
+}
+
+/*!
+    @brief  Get the coil pulses this panel has fired in total.
+    @return Pulses since construction, including begin()'s sweep.
+*/
+uint32_t Adafruit_HANOVER_FLIPDOT::getTotalPulses(void) {
+  return total_pulses;
+}
+
+/*!
+    @brief  List the most-pulsed dots (or groups), most worn first.
+    @param  out
+            Array to fill, n entries long.
+    @param  n
+            Number of entries wanted.
+    @return Number of entries filled: n, or fewer if there are fewer
+            counters or wear tracking is off.
+    @note   One pass over the table with an insertion into out, so cheap
+            for the handful of entries a maintenance report needs.
+*/
+uint8_t Adafruit_HANOVER_FLIPDOT::getHottestDots(HANOVER_FLIPDOT_Wear *out,
+                                                 uint8_t n) {
+  uint16_t entries;
+  uint32_t *table = getWearTable(&entries);
+  uint8_t found = 0;
+  for (uint16_t i = 0; table && (i < entries); i++) {
+    uint32_t v = table[i];
+    if ((found == n) && (!n || (v <= out[n - 1].pulses)))
+      continue;
+    uint8_t j = (found < n) ? found++ : n - 1;
+    for (; j && (out[j - 1].pulses < v); j--)
+      out[j] = out[j - 1];
+    out[j].x = i % WIDTH;
+    out[j].y = wear_grouped ? (i / WIDTH) * 8 : i / WIDTH;
+    out[j].pulses = v;
+  }
+  return found;
+}
+
+/*!
+    @brief  Get the raw wear counters, e.g. to save them alongside the
+            dot state or to restore them after a reset.
+    @param  entries
+            Set to the number of counters.
+    @return Pointer to the counters (row-major per dot, or in getBuffer()
+            layout when grouped), or NULL if wear tracking is off.
+*/
+uint32_t *Adafruit_HANOVER_FLIPDOT::getWearTable(uint16_t *entries) {
+  *entries =
+      !wear ? 0 : (wear_grouped ? WIDTH * ((HEIGHT + 7) / 8) : WIDTH * HEIGHT);
+  return wear;
+}
+
+// STUCK-DOT EXERCISE ------------------------------------------------------
+
+/*!
+    @brief  Start (or stop) re-pulsing long-unchanged dots in idle time.
+            Dots left in one state for weeks tend to stick; pulsing them
+            again toward the state they already show keeps them free
+            without any visible change.
+    @param  pulses_per_minute
+            Coil pulse budget for exercise, or 0 to stop.
+    @return true on success, false if the bookkeeping (one bit per 8-dot
+            group) could not be allocated.
+    @note   Call exercise() whenever the panel is idle. The exercise works
+            through the panel in scan order, one window per call, so with
+            a budget of B a panel of N dots is covered every N / B minutes
+            at most.
+*/
+bool Adafruit_HANOVER_FLIPDOT::enableExercise(uint16_t pulses_per_minute) {
+  exercise_rate = pulses_per_minute;
+  if (!pulses_per_minute) {
+    free(touched);
+    touched = NULL;
+    return true;
+  }
+  if (!touched &&
+      !(touched = (uint8_t *)calloc((WIDTH * ((HEIGHT + 7) / 8) + 7) / 8, 1)))
+    return false;
+  exercise_tokens = 0;
+  exercise_ms = millis();
+  return true;
+}
+
+/*!
+    @brief  Spend the exercise budget earned since the last call.
+    @return Number of dots pulsed.
+    @note   Only dots that show their target, are not marked unknown, and
+            whose 8-dot group no refresh has pulsed since the exercise last
+            passed it are re-pulsed. Returns at once when a refresh is
+            requested (display() from an ISR, a new commitFrame()), so real
+            frames are never held up by more than one dot. Call from the
+            context that refreshes the panel.
+*/
+uint16_t Adafruit_HANOVER_FLIPDOT::exercise(void) {
+  if (!touched || !shadow ||
+      __atomic_exchange_n(&scanning, 1, __ATOMIC_ACQUIRE))
+    return 0;
+  uint32_t now = millis(), cap = (uint32_t)exercise_rate * 1000;
+  if (cap < 60000)
+    cap = 60000; // At most a second's worth, but always room for one pulse
+  // Compare before multiplying: a long idle gap times the rate overflows
+  uint32_t elapsed = now - exercise_ms, room = cap - exercise_tokens;
+  exercise_ms = now;
+  if (elapsed >= room / exercise_rate)
+    exercise_tokens = cap;
+  else
+    exercise_tokens += elapsed * exercise_rate;
+  const uint8_t *frame = frames[1] ? frames[front_idx] : buffer;
+  uint16_t done = 0;
+  exercising = true;
+  for (uint16_t left = WIDTH * HEIGHT;
+       left && (exercise_tokens >= 60000); left--) {
+    if (__atomic_load_n(&preempt, __ATOMIC_RELAXED) ||
+        (frames[1] &&
+         (__atomic_load_n(&handoff, __ATOMIC_RELAXED) & HANOVER_FLIPDOT_FRESH)))
+      break; // A real frame is waiting
+    uint8_t x = exercise_x, y = exercise_y;
+    if (++exercise_x >= WIDTH) {
+      exercise_x = 0;
+      if (++exercise_y >= HEIGHT)
+        exercise_y = 0;
+    }
+    uint16_t i = x + (y / 8) * WIDTH;
+    uint8_t mask = 1 << (y & 7), bit = 1 << (i & 7);
+    bool fresh = touched[i / 8] & bit;
+    if (((y & 7) == 7) || (y == HEIGHT - 1))
+      touched[i / 8] &= ~bit; // Leaving the group; start watching it again
+    if (fresh || ((frame[i] ^ shadow[i] ^ invert_mask) & mask) ||
+        (unknown && (unknown[i] & mask)))
+      continue;
+    moveTo(x, y);
+    pulseDot(shadow[i] & mask);
+    exercise_tokens -= 60000;
+    done++;
+  }
+  exercising = false;
+  __atomic_store_n(&scanning, 0, __ATOMIC_RELEASE);
+  if (!frames[1] && __atomic_load_n(&preempt, __ATOMIC_ACQUIRE))
+    display(); // Serve the display() that arrived meanwhile
+  return done;
+}
+
+// COPY-ON-WRITE -----------------------------------------------------------
+
+/*!
+    @brief  Set aside private page copies so drawing can continue, without
+            tearing, while another context (timer ISR, second core) runs a
+            refresh started with requestDisplay().
+    @param  pages
+            Number of page copies (WIDTH bytes each) to allocate, at most
+            HANOVER_FLIPDOT_COW_SLOTS. 0 frees them again, in which case a
+            draw into a page the refresh has not reached yet waits for it.
+    @return true on successful allocation, false otherwise.
+    @note   Only costs the memory of the pages drawn to while a refresh is
+            in flight, rather than a whole second frame. Drawing through
+            drawPixel() (so all Adafruit_GFX primitives and
+            HANOVER_FLIPDOT_Tiled), clearDisplay() and the bulk buffer
+            operations is covered; direct getBuffer() writes, tickers and
+            transitions are not, and must not be used during a refresh.
+*/
+bool Adafruit_HANOVER_FLIPDOT::enableCopyOnWrite(uint8_t pages) {
+  if (!commitPages())
+    return false;
+  if (pages > HANOVER_FLIPDOT_COW_SLOTS)
+    pages = HANOVER_FLIPDOT_COW_SLOTS;
+  free(cow_pool);
+  cow_pool = NULL;
+  cow_slots = 0;
+  if (pages && !(cow_pool = (uint8_t *)malloc(pages * WIDTH)))
+    return false;
+  cow_slots = pages;
+  cow_used = 0;
+  memset(cow_page, HANOVER_FLIPDOT_COW_FREE, sizeof(cow_page));
+  return true;
+}
+
+/*!
+    @brief  Start a refresh of the current buffer, to be run by
+            serviceDisplay() in another context. Returns at once; drawing
+            may continue and becomes part of the next frame.
+    @return true if the refresh was started, false if the previous one is
+            still running.
+    @note   Call from the drawing side only.
+*/
+bool Adafruit_HANOVER_FLIPDOT::requestDisplay(void) {
+  if (!commitPages())
+    return false;
+  __atomic_store_n(&refresh_page, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&cow_active, 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+/*!
+    @brief  Run a refresh started by requestDisplay(), page by page,
+            publishing progress so the drawing side knows which pages it
+            may write directly again.
+    @return true if a refresh was run, false if none was requested.
+    @note   Call from the refresh side only (ISR, task or second core).
+*/
+bool Adafruit_HANOVER_FLIPDOT::serviceDisplay(void) {
+  if (!__atomic_load_n(&cow_active, __ATOMIC_ACQUIRE))
+    return false;
+  uint8_t pages = (HEIGHT + 7) / 8;
+  uint32_t start = micros();
+  for (uint8_t p = 0; p < pages; p++) {
+    uint8_t last = (p * 8 + 7 < HEIGHT) ? p * 8 + 7 : HEIGHT - 1;
+    refresh(buffer, 0, p * 8, WIDTH - 1, last);
+    __atomic_store_n(&refresh_page, p + 1, __ATOMIC_RELEASE);
+  }
+  timeRefresh(start);
+  __atomic_store_n(&cow_active, 0, __ATOMIC_RELEASE);
+  return true;
+}
+
+/*!
+    @brief  Copy a page copy back into the buffer and free its slot.
+    @param  slot
+            Slot index. Free slots are ignored.
+    @return None (void).
+    @note   Only valid once the refresh has passed the slot's page.
+*/
+void Adafruit_HANOVER_FLIPDOT::commitPage(uint8_t slot) {
+  uint8_t page = cow_page[slot];
+  if (page == HANOVER_FLIPDOT_COW_FREE)
+    return;
+  memcpy(&buffer[page * WIDTH], &cow_pool[slot * WIDTH], WIDTH);
+  cow_page[slot] = HANOVER_FLIPDOT_COW_FREE;
+  cow_used--;
+}
+
+/*!
+    @brief  Fold every page copy back into the buffer once no refresh
+            started by requestDisplay() is reading it any more.
+    @return true if the buffer is now current, false if a refresh is still
+            in flight (copies are kept).
+    @note   Drawing side only. serviceDisplay() cannot do this itself, as
+            the copies belong to the drawing side.
+*/
+bool Adafruit_HANOVER_FLIPDOT::commitPages(void) {
+  if (__atomic_load_n(&cow_active, __ATOMIC_ACQUIRE))
+    return false;
+  for (uint8_t i = 0; cow_used && (i < cow_slots); i++)
+    commitPage(i);
+  return true;
+}
+
+/*!
+    @brief  Get the page to read while a refresh may be in flight: the
+            private copy if there is one, else the buffer.
+    @param  page
+            Page (band of 8 rows) index.
+    @return Pointer to the first byte of the page.
+*/
+const uint8_t *Adafruit_HANOVER_FLIPDOT::readablePage(uint8_t page) {
+  for (uint8_t i = 0; cow_used && (i < cow_slots); i++)
+    if (cow_page[i] == page)
+      return &cow_pool[i * WIDTH];
+  return &buffer[page * WIDTH];
+}
+
+/*!
+    @brief  Get the page to draw into while a refresh may be in flight.
+            Pages the refresh is done with are written in place (folding
+            back any copy first); the page being read and pages still to be
+            read are redirected to a private copy.
+    @param  page
+            Page (band of 8 rows) index.
+    @return Pointer to the first byte of the page.
+    @note   Waits for the refresh only if the page needs a copy and every
+            slot holds a page the refresh has not reached yet. Copies left
+            over from a finished refresh are folded back on the way.
+*/
+uint8_t *Adafruit_HANOVER_FLIPDOT::writablePage(uint8_t page) {
+  if (!cow_used && !__atomic_load_n(&cow_active, __ATOMIC_RELAXED))
+    return &buffer[page * WIDTH]; // Nothing in flight, nothing to fold
+  uint8_t slot = HANOVER_FLIPDOT_COW_FREE, free_slot = HANOVER_FLIPDOT_COW_FREE;
+  for (;;) {
+    uint8_t done = __atomic_load_n(&refresh_page, __ATOMIC_ACQUIRE);
+    if (!__atomic_load_n(&cow_active, __ATOMIC_ACQUIRE))
+      done = 0xFF; // Finished meanwhile; everything is safe to write
+    for (uint8_t i = 0; i < cow_slots; i++) {
+      uint8_t p = cow_page[i];
+      if (p == page)
+        slot = i;
+      else if ((p != HANOVER_FLIPDOT_COW_FREE) && (p < done))
+        commitPage(i);
+      if (cow_page[i] == HANOVER_FLIPDOT_COW_FREE)
+        free_slot = i;
+    }
+    if (page < done) {
+      if (slot != HANOVER_FLIPDOT_COW_FREE)
+        commitPage(slot);
+      return &buffer[page * WIDTH];
+    }
+    if (slot != HANOVER_FLIPDOT_COW_FREE)
+      return &cow_pool[slot * WIDTH];
+    if (free_slot != HANOVER_FLIPDOT_COW_FREE) {
+      memcpy(&cow_pool[free_slot * WIDTH], &buffer[page * WIDTH], WIDTH);
+      cow_page[free_slot] = page;
+      cow_used++;
+      return &cow_pool[free_slot * WIDTH];
+    }
+    // Out of slots: wait for the refresh to move past something
+  }
+}
+
+// STREAMING RENDER --------------------------------------------------------
+
+/*!
+    @brief  Switch to streaming mode, for boards without the RAM for a
+            buffer and a shadow. Instead of drawing, the application
+            describes what to show with a state value, and the renderer
+            turns a state into the dots of one page on demand.
+    @param  render
+            Page renderer. It must be a pure function of its arguments:
+            the panel's physical state is kept as the state it was last
+            rendered from, and re-rendered to diff against.
+    @param  ctx
+            Passed to render, e.g. a PROGMEM string. Default if
+            unspecified is NULL.
+    @return None (void).
+    @note   Call before begin(), which then allocates 2 * WIDTH bytes
+            instead of two copies of the panel. There is no buffer, so
+            getBuffer() returns NULL and the drawing, buffer, triple
+            buffering and copy-on-write functions must not be used;
+            display() re-renders the current state.
 */
+void Adafruit_HANOVER_FLIPDOT::setRenderer(HANOVER_FLIPDOT_Render render,
+                                           void *ctx) {
+  this->render = render;
+  render_ctx = ctx;
+}
+
+/*!
+    @brief  Show a state in streaming mode. Page by page, in counter scan
+            order, the renderer produces the target and the page as it was
+            last shown, and only the dots that differ are pulsed.
+    @param  state
+            Passed to the renderer.
+    @return None (void).
+    @note   Not preemptible: the pass always runs to the end, so the panel
+            is never left between two states.
+*/
+void Adafruit_HANOVER_FLIPDOT::displayState(uint32_t state) {
+  if (!render_page)
+    return;
+  HANOVER_FLIPDOT_TRACE(HANOVER_FLIPDOT_EV_SCAN, 0, HEIGHT - 1);
+  uint32_t start = micros();
+  uint8_t *b = render_page, *s = render_page + WIDTH, inv = invert_mask;
+  for (uint8_t p = 0; p < (HEIGHT + 7) / 8; p++) {
+    render(p, state, b, render_ctx);
+    if (render_blank)
+      memset(s, 0, WIDTH);
+    else
+      render(p, render_state, s, render_ctx);
+    // Dots shown are s ^ flip, dots wanted are b ^ inv
+    uint8_t flip = render_blank ? 0 : render_inv;
+    if (!render_unknown &&
+        !(diffBytes(b, s, inv ^ flip, WIDTH) & pageRows(p)))
+      continue;
+    for (uint8_t y = p * 8; (y < HEIGHT) && (y < p * 8 + 8); y++) {
+      uint8_t mask = 1 << (y & 7);
+      HANOVER_FLIPDOT_TRACE(HANOVER_FLIPDOT_EV_ROW, y, 0);
+      for (uint8_t x = 0; x < WIDTH; x++) {
+        if (render_unknown || ((b[x] ^ s[x] ^ inv ^ flip) & mask)) {
+          moveTo(x, y);
+          pulseDot((b[x] ^ inv) & mask);
+        }
+      }
+    }
+  }
+  render_state = state;
+  render_inv = inv;
+  render_blank = false;
+  render_unknown = false;
+  HANOVER_FLIPDOT_TRACE(HANOVER_FLIPDOT_EV_DONE, 0, 0);
+  timeRefresh(start);
+}
+
+// TEXT MEASUREMENT --------------------------------------------------------
+
+/*!
+    @brief  Get the width and height of a string as getTextBounds() would
+            report it at (0,0), remembering recent results so repeated
+            layout passes over the same strings skip the glyph walk.
+    @param  str
+            Null-terminated string to measure.
+    @param  w
+            Pointer to returned width in pixels.
+    @param  h
+            Pointer to returned height in pixels.
+    @return None (void).
+    @note   Entries are keyed by a hash of the string contents plus the
+            current font, text size, rotation, text wrap and CP437 mode, so
+            changing any of those simply misses the cache. A hit still reads the string once to
+            hash it, but does no glyph lookups.
+*/
+void Adafruit_HANOVER_FLIPDOT::getTextExtent(const char *str, uint16_t *w,
+                                             uint16_t *h) {
+  uint32_t hash = 2166136261UL; // FNV-1a offset basis
+  uint16_t len = 0;
+  for (const char *p = str; *p; p++, len++) {
+    hash ^= (uint8_t)*p;
+    hash *= 16777619UL;
+  }
+  uint8_t flags = (wrap ? 1 : 0) | (_cp437 ? 2 : 0);
+
+  for (uint8_t i = 0; i < HANOVER_FLIPDOT_TEXT_CACHE_SIZE; i++) {
+    HANOVER_FLIPDOT_TextExtent *e = &text_cache[i];
+    if ((e->len == len) && (e->hash == hash) && (e->font == gfxFont) &&
+        (e->size_x == textsize_x) && (e->size_y == textsize_y) &&
+        (e->rotation == rotation) && (e->flags == flags)) {
+      *w = e->w;
+      *h = e->h;
+      return;
+    }
+  }
+
+  int16_t x1, y1;
+  getTextBounds(str, 0, 0, &x1, &y1, w, h);
+  if (!len)
+    return; // Slot length 0 means empty, don't cache ""
+
+  HANOVER_FLIPDOT_TextExtent *e = &text_cache[text_cache_next];
+  if (++text_cache_next >= HANOVER_FLIPDOT_TEXT_CACHE_SIZE)
+    text_cache_next = 0;
+  e->hash = hash;
+  e->len = len;
+  e->font = gfxFont;
+  e->size_x = textsize_x;
+  e->size_y = textsize_y;
+  e->rotation = rotation;
+  e->flags = flags;
+  e->w = *w;
+  e->h = *h;
+}
+
+/*!
+    @brief  Get the horizontal advance of a string in the current font and
+            text size, i.e. how far the cursor moves when it is printed.
+    @param  str
+            Null-terminated string to measure. For multi-line strings the
+            widest line is returned.
+    @return Advance in pixels.
+    @note   Reads only the per-glyph xAdvance table of the font (a fixed 6
+            pixels for the built-in font), never the glyph bitmaps or ink
+            bounds, and ignores text wrap. This is the usual figure for
+            centring or right-aligning a line.
+*/
+uint16_t Adafruit_HANOVER_FLIPDOT::getTextAdvance(const char *str) {
+  uint16_t line = 0, widest = 0;
+  uint8_t first = 0, last = 0;
+  GFXglyph *glyph = NULL;
+  if (gfxFont) {
+    first = pgm_read_byte(&gfxFont->first);
+    last = pgm_read_byte(&gfxFont->last);
+    glyph = (GFXglyph *)pgm_read_pointer(&gfxFont->glyph);
+  }
+
+  for (uint8_t c; (c = *str); str++) {
+    if (c == '\n') {
+      if (line > widest)
+        widest = line;
+      line = 0;
+    } else if (c == '\r') {
+      continue;
+    } else if (!gfxFont) {
+      line += 6;
+    } else if ((c >= first) && (c <= last)) {
+      line += pgm_read_byte(&glyph[c - first].xAdvance);
+    }
+  }
+  if (line > widest)
+    widest = line;
+  return widest * textsize_x;
+}
+
+/*!
+    @brief  Forget all cached text extents.
+    @return None (void).
+    @note   Only needed if a string is measured again after the font data
+            it was measured with has been modified in place.
+*/
+void Adafruit_HANOVER_FLIPDOT::clearTextCache(void) {
+  memset(text_cache, 0, sizeof(text_cache));
+  text_cache_next = 0;
+}
+
+// REFRESH DISPLAY ---------------------------------------------------------
+
 /*!
     @brief  Push data currently in RAM to HANOVER_FLIPDOT display.
+    @param  priority
+            Urgency of this frame. A call with a higher priority than the
+            refresh in progress (made from an ISR, or another task drawing
+            into the same buffer) stops it at the next dot and restarts it
+            toward the buffer as it is then. Default if unspecified is 0.
     @return None (void).
     @note   Drawing operations are not visible until this function is
             called. Call after each graphics command, or after a whole set
             of graphics commands, as best needed by one's own application.
+            Only dots whose buffer state differs from the panel's last
+            driven state are pulsed.
+*/
+void Adafruit_HANOVER_FLIPDOT::display(uint8_t priority) {
+  scan(priority, 0, 0, WIDTH - 1, HEIGHT - 1);
+}
+
+/*!
+    @brief  Push part of the buffer to the panel, leaving dots outside the
+            window untouched even if they differ from the buffer.
+    @param  x
+            Left column of the window, in unrotated panel coordinates.
+    @param  y
+            Top row of the window, in unrotated panel coordinates.
+    @param  w
+            Width of the window in dots.
+    @param  h
+            Height of the window in dots.
+    @param  priority
+            As for display(). Default if unspecified is 0.
+    @return None (void).
+    @note   Use when only a known area was changed (for example by a
+            HANOVER_FLIPDOT_Ticker) to skip diffing the rest of the buffer.
+*/
+void Adafruit_HANOVER_FLIPDOT::displayRegion(int16_t x, int16_t y, int16_t w,
+                                             int16_t h, uint8_t priority) {
+  if (clipRegion(&x, &y, &w, &h))
+    scan(priority, x, y, x + w - 1, y + h - 1);
+}
+
+/*!
+    @brief  Forget what part of the panel shows, e.g. after a suspected
+            counter glitch or interference on the coil lines. The next
+            refresh pulses every dot in the rectangle to its buffer state
+            once, whether or not the shadow says it already is.
+    @param  x
+            Left column, in unrotated panel coordinates.
+    @param  y
+            Top row, in unrotated panel coordinates.
+    @param  w
+            Width in dots.
+    @param  h
+            Height in dots.
+    @return true on success, false if the unknown map (one bit per dot,
+            allocated on first use) could not be allocated.
+    @note   Dots outside the rectangle keep normal diff treatment, so
+            recovery costs only the affected area. Any state saved with
+            HANOVER_FLIPDOT_Persist is invalidated until the next save. In
+            streaming mode there is no map: the next displayState() drives
+            every dot instead.
+*/
+bool Adafruit_HANOVER_FLIPDOT::markUnknown(int16_t x, int16_t y, int16_t w,
+                                           int16_t h) {
+  if (render) {
+    render_unknown = true;
+    return true;
+  }
+  uint16_t size = WIDTH * ((HEIGHT + 7) / 8);
+  if (!unknown && !(unknown = (uint8_t *)calloc(size, 1)))
+    return false;
+  if (!clipRegion(&x, &y, &w, &h))
+    return true;
+  int16_t y1 = y + h - 1;
+  for (uint8_t p = y / 8; p <= y1 / 8; p++) {
+    uint8_t bits = 0xFF;
+    if (p == y / 8)
+      bits &= 0xFF << (y & 7);
+    if (p == y1 / 8)
+      bits &= 0xFF >> (7 - (y1 & 7));
+    maskBytes(&unknown[p * WIDTH + x], bits, w, HANOVER_FLIPDOT_OP_OR);
+  }
+  if (persisted) {
+    persisted = 0;
+    persist->invalidate();
+  }
+  return true;
+}
+
+/*!
+    @brief  Check whether any dot is still marked unknown.
+    @return true if a refresh has yet to re-drive some dot.
+*/
+bool Adafruit_HANOVER_FLIPDOT::anyUnknown(void) {
+  if (render)
+    return render_unknown;
+  if (!unknown)
+    return false;
+  for (uint8_t p = 0; p < (HEIGHT + 7) / 8; p++)
+    if (orBytes(&unknown[p * WIDTH], WIDTH) & pageRows(p))
+      return true;
+  return false;
+}
+
+/*!
+    @brief  Bound how far the open-loop counters run between resets.
+    @param  advances
+            Most advance pulses (both counters) allowed between two counter
+            resets, or 0 (the default) to reset only when it saves pulses.
+    @return None (void).
+    @note   Each reset is a checkpoint: a pulse lost to noise can only
+            misplace dots up to the next one, and redriveSegment() repairs
+            that segment alone. Lower values bound a glitch more tightly
+            at the cost of extra resets and re-counting; estimateRefresh()
+            includes them. Needs reset_pin. Values below WIDTH + HEIGHT
+            are raised to it: a counter reset alone can cost up to
+            (WIDTH - 1) + (HEIGHT - 1) advances to get back to a dot, so
+            anything less would reset before nearly every dot.
+*/
+void Adafruit_HANOVER_FLIPDOT::setCheckpointInterval(uint16_t advances) {
+  if (advances && (advances < (uint16_t)WIDTH + HEIGHT))
+    advances = WIDTH + HEIGHT;
+  checkpoint_every = advances;
+}
+
+/*!
+    @brief  Repair the panel after a suspected lost counter pulse by
+            re-driving every dot the counters may have misplaced since the
+            last checkpoint, then resynchronizing the counters.
+    @return true on success, false if the unknown map could not be
+            allocated.
+    @note   Covers the rows addressed since the last reset plus the row
+            above (a lost row pulse lands dots one row early), full width.
+            The rest of the panel is left alone, except in streaming mode,
+            where the whole panel is re-driven from the current state.
 */
-void Adafruit_HANOVER_FLIPDOT::display(void) {
-  TRANSACTION_START
-  static const uint8_t PROGMEM dlist1[] = {
-      HANOVER_FLIPDOT_PAGEADDR,
-      0,                      // Page start address
-      0xFF,                   // Page end (not really, but works here)
-      HANOVER_FLIPDOT_COLUMNADDR, 0}; // Column start address
-  HANOVER_FLIPDOT_commandList(dlist1, sizeof(dlist1));
-  HANOVER_FLIPDOT_command1(WIDTH - 1); // Column end address
-
-  uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
-  uint8_t *ptr = buffer;
-  if (wire) { // I2C
-    wire->beginTransmission(i2caddr);
-    WIRE_WRITE((uint8_t)0x40);
-    uint16_t bytesOut = 1;
-    while (count--) {
-      if (bytesOut >= WIRE_MAX) {
-        wire->endTransmission();
-        wire->beginTransmission(i2caddr);
-        WIRE_WRITE((uint8_t)0x40);
-        bytesOut = 1;
+bool Adafruit_HANOVER_FLIPDOT::redriveSegment(void) {
+  if (seg_lo > seg_hi)
+    return true; // Nothing driven since the checkpoint
+  uint8_t y0 = seg_lo ? seg_lo - 1 : 0, y1 = seg_hi;
+  if (!markUnknown(0, y0, WIDTH, y1 - y0 + 1))
+    return false;
+  if (reset_pin >= 0)
+    resetCounters();
+  scan(0, 0, y0, WIDTH - 1, y1);
+  return true;
+}
+
+/*!
+    @brief  Get the frame interval the panel can currently sustain.
+    @return Smoothed duration of recent refreshes, in microseconds. 0
+            until the first refresh.
+    @note   Refresh time grows with the number of dots that change, so
+            this follows the content. Together with triple buffering it
+            is the frame-rate governor: draw and commitFrame() at any
+            rate, while displayLatest() on the refresh side always takes
+            the newest committed frame and skips the ones in between, so
+            the panel never falls behind. Pace the drawing by this
+            interval to avoid rendering frames that will be skipped.
+*/
+uint32_t Adafruit_HANOVER_FLIPDOT::getFrameInterval(void) { return refresh_us; }
+
+/*!
+    @brief  Predict what refreshing to a frame would cost, without touching
+            the panel.
+    @param  cost
+            Filled in with the prediction.
+    @param  frame
+            Frame in getBuffer() layout, or NULL (the default) for the
+            current buffer.
+    @return None (void).
+    @note   The dot count is exact (a popcount of the frame against the
+            shadow, plus dots marked unknown). Counter movement is modelled per page rather than
+            per row: every row of a page with changes is assumed to span
+            that page's first to last changed column, which errs on the
+            high side. Cheap enough to call before every frame, e.g. to
+            hold back a large change until a quiet moment. Streaming mode
+            has no shadow to compare against, so there every field is 0.
+*/
+void Adafruit_HANOVER_FLIPDOT::estimateRefresh(
+    HANOVER_FLIPDOT_RefreshCost *cost, const uint8_t *frame) {
+  if (render) {
+    memset(cost, 0, sizeof(*cost));
+    return;
+  }
+  if (!frame)
+    frame = buffer;
+  uint32_t dots = 0, advances = 0, resets = 0;
+  uint8_t c = col_idx, r = row_idx;
+  uint16_t since = since_reset;
+  for (uint8_t p = 0; p < (HEIGHT + 7) / 8; p++) {
+    const uint8_t *b = &frame[p * WIDTH], *s = &shadow[p * WIDTH];
+    const uint8_t *u = unknown ? &unknown[p * WIDTH] : NULL;
+    uint8_t rows = pageRows(p), active = 0, first = 0, last = 0;
+    for (uint8_t i = 0; i < WIDTH; i++) {
+      uint8_t d = ((b[i] ^ s[i] ^ invert_mask) | (u ? u[i] : 0)) & rows;
+      if (d) {
+        if (!active)
+          first = i;
+        last = i;
+        active |= d;
+        dots += __builtin_popcount(d);
+      }
+    }
+    for (uint8_t y = p * 8; active; active >>= 1, y++) {
+      if (!(active & 1))
+        continue;
+      // Same choice as moveTo(), then across to the last column
+      uint8_t dc = (first - c) & (HANOVER_FLIPDOT_COUNTER_STEPS - 1);
+      uint8_t dr = (y - r) & (HANOVER_FLIPDOT_COUNTER_STEPS - 1);
+      if (wantReset(first, y, dc, dr, since)) {
+        resets++;
+        dc = first;
+        dr = y;
+        since = 0;
+      }
+      advances += dc + dr;
+      since += dc + dr;
+      // Across the row, with any checkpoints the budget forces on the way
+      uint8_t x = first, left = last - first;
+      while (left && checkpoint_every && (reset_pin >= 0) &&
+             (since + left > checkpoint_every)) {
+        uint8_t go = (checkpoint_every > since) ? checkpoint_every - since : 0;
+        if (go > left - 1)
+          go = left - 1;
+        x += go + 1;
+        left -= go + 1;
+        resets++;
+        advances += go + x + y;
+        since = x + y;
+      }
+      advances += left;
+      since += left;
+      c = last;
+      r = y;
+    }
+  }
+  cost->dots = dots;
+  cost->resets = resets;
+  cost->advances = advances;
+  cost->us = dots * ((uint32_t)timing.settle_us + timing.coil_us) +
+             advances * (2UL * timing.advance_us) +
+             resets * (uint32_t)timing.reset_us;
+}
+
+/*!
+    @brief  Fold the duration of a refresh into the running average behind
+            getFrameInterval().
+    @param  start
+            micros() when the refresh began.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::timeRefresh(uint32_t start) {
+  uint32_t took = micros() - start;
+  if (refresh_us)
+    refresh_us += (int32_t)(took - refresh_us) /
+                  (1 << HANOVER_FLIPDOT_GOVERNOR_SHIFT);
+  else
+    refresh_us = took; // First sample
+}
+
+/*!
+    @brief  Refresh a window of the buffer, or hand the request to a scan
+            that is already running, restarting on preemption.
+    @param  priority
+            Priority of the request.
+    @param  x0
+            First column (inclusive).
+    @param  y0
+            First row (inclusive).
+    @param  x1
+            Last column (inclusive).
+    @param  y1
+            Last row (inclusive).
+    @return None (void).
+    @note   A request arriving while a scan runs is always served, either
+            by preempting it or by one more pass once it finishes. Passes
+            after the first cover the whole panel, since the request that
+            caused them may lie outside the window. The shadow is updated
+            dot by dot, so every pass diffs against what the panel really
+            shows and never pulses a dot that no longer needs it.
+*/
+void Adafruit_HANOVER_FLIPDOT::scan(uint8_t priority, uint8_t x0, uint8_t y0,
+                                    uint8_t x1, uint8_t y1) {
+  HANOVER_FLIPDOT_TRACE(HANOVER_FLIPDOT_EV_DISPLAY, priority, 0);
+  if (render) { // Streaming mode: re-render, e.g. after invertDisplay()
+    displayState(render_state);
+    return;
+  }
+  raiseLevel(&preempt, (priority < 0xFE) ? priority + 1 : 0xFE);
+  if (__atomic_exchange_n(&scanning, 1, __ATOMIC_ACQUIRE))
+    return; // The running scan picks this request up
+  commitPages(); // Drawn during an earlier requestDisplay() pass
+  uint32_t start = micros();
+  for (;;) {
+    scan_level = __atomic_exchange_n(&preempt, 0, __ATOMIC_ACQ_REL);
+    bool done = refresh(buffer, x0, y0, x1, y1);
+    x0 = y0 = 0;
+    x1 = WIDTH - 1;
+    y1 = HEIGHT - 1;
+    if (!done)
+      continue; // Preempted: rescan toward the newer target
+    scan_level = 0xFF;
+    timeRefresh(start);
+    __atomic_store_n(&scanning, 0, __ATOMIC_RELEASE);
+    if (!__atomic_load_n(&preempt, __ATOMIC_ACQUIRE) ||
+        __atomic_exchange_n(&scanning, 1, __ATOMIC_ACQUIRE))
+      return;
+  }
+}
+
+/*!
+    @brief  Drive every dot in a window that differs between a frame and
+            the shadow to its frame state, updating the shadow as it goes.
+    @param  frame
+            Frame to show, in getBuffer() layout (normally buffer).
+    @param  x0
+            First column (inclusive).
+    @param  y0
+            First row (inclusive).
+    @param  x1
+            Last column (inclusive).
+    @param  y1
+            Last row (inclusive).
+    @return true when the window is done, false if a request above
+            scan_level stopped it first.
+    @note   Dots are visited row by row, left to right, which keeps the
+            column counter counting forward for the whole row and needs a
+            single reset or wrap per row. Whole pages with no difference in
+            the window are skipped without testing individual rows.
+*/
+bool Adafruit_HANOVER_FLIPDOT::refresh(const uint8_t *frame, uint8_t x0,
+                                       uint8_t y0, uint8_t x1, uint8_t y1) {
+  HANOVER_FLIPDOT_TRACE(HANOVER_FLIPDOT_EV_SCAN, y0, y1);
+  uint8_t n = x1 - x0 + 1, inv = invert_mask;
+  for (uint8_t y = y0; y <= y1; y++) {
+    uint16_t offset = (y / 8) * WIDTH + x0;
+    const uint8_t *b = &frame[offset];
+    uint8_t *s = &shadow[offset];
+    uint8_t *u = unknown ? &unknown[offset] : NULL;
+    if (((y & 7) == 0 || y == y0) &&
+        !((diffBytes(b, s, inv, n) | (u ? orBytes(u, n) : 0)) &
+          pageRows(y / 8))) {
+      y |= 7; // Nothing to do in the rest of this page
+      if (y >= y1)
+        break;
+      continue;
+    }
+    uint8_t mask = 1 << (y & 7);
+    HANOVER_FLIPDOT_TRACE(HANOVER_FLIPDOT_EV_ROW, y, 0);
+    for (uint8_t i = 0; i < n; i++) {
+      if (((b[i] ^ s[i] ^ inv) | (u ? u[i] : 0)) & mask) {
+        if (__atomic_load_n(&preempt, __ATOMIC_RELAXED) > scan_level) {
+          HANOVER_FLIPDOT_TRACE(HANOVER_FLIPDOT_EV_PREEMPT, y, 0);
+          return false;
+        }
+        moveTo(x0 + i, y);
+        uint8_t on = (b[i] ^ inv) & mask;
+        pulseDot(on);
+        s[i] = (s[i] & ~mask) | on;
+        if (u)
+          u[i] &= ~mask;
       }
-      WIRE_WRITE(*ptr++);
-      bytesOut++;
     }
-    wire->endTransmission();
-  } else { // SPI
-    HANOVER_FLIPDOT_MODE_DATA
-    while (count--)
-      SPIwrite(*ptr++);
   }
-  TRANSACTION_END
+  HANOVER_FLIPDOT_TRACE(HANOVER_FLIPDOT_EV_DONE, 0, 0);
+  return true;
+}
+
+/*!
+    @brief  Drive a single dot to its buffer state if the panel differs.
+    @param  x
+            Column, unrotated.
+    @param  y
+            Row, unrotated.
+    @return true if the dot was pulsed, false if it was already correct.
+    @note   For callers that choose their own dot order, such as
+            HANOVER_FLIPDOT_Transition. The shadow is updated, so a dot is
+            never pulsed twice for the same buffer contents. Always false
+            in streaming mode, which has no buffer.
+*/
+bool Adafruit_HANOVER_FLIPDOT::refreshDot(uint8_t x, uint8_t y) {
+  if (render)
+    return false;
+  uint16_t i = x + (y / 8) * WIDTH;
+  uint8_t mask = 1 << (y & 7);
+  if (!(((buffer[i] ^ shadow[i] ^ invert_mask) | (unknown ? unknown[i] : 0)) &
+        mask))
+    return false;
+  moveTo(x, y);
+  uint8_t on = (buffer[i] ^ invert_mask) & mask;
+  pulseDot(on);
+  shadow[i] = (shadow[i] & ~mask) | on;
+  if (unknown)
+    unknown[i] &= ~mask;
+  return true;
+}
+
+/*!
+    @brief  Pulse every dot of the panel to one state regardless of the
+            shadow, used to bring a panel of unknown state to a known one.
+    @param  on
+            true to drive every dot yellow, false for black.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::sweep(bool on) {
+  for (uint8_t y = 0; y < HEIGHT; y++) {
+    for (uint8_t x = 0; x < WIDTH; x++) {
+      moveTo(x, y);
+      pulseDot(on);
+    }
+  }
+}
+
+/*!
+    @brief  Drive this panel's enable pin high and the others low, so
+            counter and coil pulses reach this panel only.
+    @return None (void).
+    @note   Cheap to call repeatedly: the pins are only written when a
+            different panel was the last one driven.
+*/
+void Adafruit_HANOVER_FLIPDOT::selectPanel(void) {
+  if (selected == this)
+    return;
+  int8_t pins[4] = {disp1_enable_pin, disp2_enable_pin, disp3_enable_pin,
+                    disp4_enable_pin};
+  for (uint8_t i = 0; i < 4; i++)
+    if (pins[i] >= 0)
+      pinWrite(pins[i], (i + 1 == panel_idx) ? HIGH : LOW);
+  selected = this;
+}
+
+/*!
+    @brief  Bring the row and column counters to a dot, either by counting
+            forward (wrapping past the end of the 7-stage counters if
+            needed) or by resetting and counting up from 0, whichever needs
+            fewer pulses.
+    @param  col
+            Column to address.
+    @param  row
+            Row to address.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::moveTo(uint8_t col, uint8_t row) {
+  selectPanel();
+  uint8_t dc = (col - col_idx) & (HANOVER_FLIPDOT_COUNTER_STEPS - 1);
+  uint8_t dr = (row - row_idx) & (HANOVER_FLIPDOT_COUNTER_STEPS - 1);
+  if (wantReset(col, row, dc, dr, since_reset)) {
+    resetCounters();
+    dc = col;
+    dr = row;
+  }
+  advance(col_adv_pin, dc);
+  advance(row_adv_pin, dr);
+  since_reset += dc + dr;
+  col_idx = col;
+  row_idx = row;
+  if (row < seg_lo)
+    seg_lo = row;
+  if (row > seg_hi)
+    seg_hi = row;
+}
+
+/*!
+    @brief  The path model: decide whether to reach a dot through a counter
+            reset rather than by counting forward.
+    @param  col
+            Column to address.
+    @param  row
+            Row to address.
+    @param  dc
+            Column advances needed without a reset.
+    @param  dr
+            Row advances needed without a reset.
+    @param  since
+            Advance pulses since the last reset.
+    @return true to reset first.
+    @note   Resets when that needs fewer pulses, or when counting on would
+            take the open-loop run past the setCheckpointInterval() budget.
+*/
+bool Adafruit_HANOVER_FLIPDOT::wantReset(uint8_t col, uint8_t row, uint8_t dc,
+                                         uint8_t dr, uint16_t since) {
+  if (reset_pin < 0)
+    return false;
+  if ((uint16_t)dc + dr > (uint16_t)col + row + HANOVER_FLIPDOT_RESET_COST)
+    return true;
+  return checkpoint_every && (since + dc + dr > checkpoint_every);
+}
+
+/*!
+    @brief  Clock a counter forward.
+    @param  pin
+            row_adv_pin or col_adv_pin.
+    @param  n
+            Number of advance pulses.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::advance(int8_t pin, uint8_t n) {
+  while (n--) {
+    pinWrite(pin, HIGH);
+    wait(timing.advance_us);
+    pinWrite(pin, LOW);
+    wait(timing.advance_us);
+  }
+}
+
+/*!
+    @brief  Return both counters to dot (0,0) using reset_pin.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::resetCounters(void) {
+  pinWrite(reset_pin, LOW);
+  wait(timing.reset_us);
+  pinWrite(reset_pin, HIGH);
+  col_idx = 0;
+  row_idx = 0;
+  since_reset = 0;
+  seg_lo = 0xFF; // New segment, empty so far
+  seg_hi = 0;
+}
+
+/*!
+    @brief  Flip the currently addressed dot.
+    @param  on
+            true to pulse the dot to yellow, false for black.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::pulseDot(bool on) {
+  if (!exercising) {
+    if (persisted) { // Stored state is about to go stale
+      persisted = 0;
+      persist->invalidate();
+    }
+    if (touched && (col_idx < WIDTH) && (row_idx < HEIGHT)) {
+      uint16_t g = col_idx + (row_idx / 8) * WIDTH;
+      touched[g / 8] |= 1 << (g & 7);
+    }
+  }
+  total_pulses++;
+  if (wear && (col_idx < WIDTH) && (row_idx < HEIGHT))
+    wear[wear_grouped ? col_idx + (row_idx / 8) * WIDTH
+                      : col_idx + row_idx * WIDTH]++;
+  pinWrite(set_pin, on ? HIGH : LOW);
+  wait(timing.settle_us);
+  pinWrite(coil_pulse_pin, HIGH);
+  wait(timing.coil_us);
+  pinWrite(coil_pulse_pin, LOW);
+}
+
+
+#if !defined(ARDUINO)
+/*!
+    @brief  Attach a pin trace (host builds only). HANOVER_FLIPDOT_VCDTrace
+            attaches itself; call this for further panels sharing its lines.
+    @param  t
+            Trace to feed every pin write and wait to, or NULL to detach.
+    @return None (void).
+*/
+void Adafruit_HANOVER_FLIPDOT::setPinTrace(HANOVER_FLIPDOT_VCDTrace *t) {
+  trace = t;
+}
+#endif
+
+/*!
+    @brief  Busy-wait a number of microseconds.
+    @param  us
+            Microseconds to wait.
+    @return None (void).
+    @note   delayMicroseconds() is only accurate up to 16383 us on AVR,
+            so longer waits are split. 0 returns at once. Host builds also
+            advance an attached trace's clock.
+*/
+void Adafruit_HANOVER_FLIPDOT::wait(uint32_t us) {
+#if !defined(ARDUINO)
+  if (trace)
+    trace->wait(us);
+#endif
+  for (; us > 16000; us -= 16000)
+    delayMicroseconds(16000);
+  if (us)
+    delayMicroseconds(us);
+}
+
+// TRACE RING --------------------------------------------------------------
+
+/*!
+    @brief  Record a trace point in the ring. Use through the
+            HANOVER_FLIPDOT_TRACE() macro, which compiles to nothing unless
+            HANOVER_FLIPDOT_TRACE_RING is set.
+    @param  event
+            HANOVER_FLIPDOT_EV_* code (application codes from 0x80 up).
+    @param  a
+            First event argument.
+    @param  b
+            Second event argument.
+    @return None (void).
+    @note   Lock-free and safe from ISRs and other cores: each call claims
+            its own slot. The oldest entries are overwritten, and the tail
+            moves up past them.
+*/
+void Adafruit_HANOVER_FLIPDOT::traceEvent(uint8_t event, uint8_t a,
+                                          uint8_t b) {
+#if HANOVER_FLIPDOT_TRACE_RING
+  uint16_t h = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+  if ((uint16_t)(h - __atomic_load_n(&trace_tail, __ATOMIC_RELAXED)) >=
+      HANOVER_FLIPDOT_TRACE_RING) // Full: slot h held the oldest entry
+    __atomic_store_n(&trace_tail,
+                     (uint16_t)(h + 1 - HANOVER_FLIPDOT_TRACE_RING),
+                     __ATOMIC_RELAXED);
+  uint16_t i = h & (HANOVER_FLIPDOT_TRACE_RING - 1);
+  trace_ring[i].t = HANOVER_FLIPDOT_TRACE_CLOCK();
+  trace_ring[i].event = event;
+  trace_ring[i].a = a;
+  trace_ring[i].b = b;
+#else
+  (void)event;
+  (void)a;
+  (void)b;
+#endif
+}
+
+/*!
+    @brief  Print the trace ring, oldest entry first, one "time event a b"
+            line per entry.
+    @param  out
+            Where to print, e.g. Serial.
+    @return None (void).
+    @note   Prints nothing when tracing is compiled out. Stop the activity
+            being traced first for a consistent snapshot.
+*/
+void Adafruit_HANOVER_FLIPDOT::dumpTrace(Print &out) {
+#if HANOVER_FLIPDOT_TRACE_RING
+  uint16_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+  // Differences of the 16-bit indices stay right when head wraps
+  uint16_t n =
+      (uint16_t)(head - __atomic_load_n(&trace_tail, __ATOMIC_RELAXED));
+  if (n > HANOVER_FLIPDOT_TRACE_RING) // Racing writers can leave tail behind
+    n = HANOVER_FLIPDOT_TRACE_RING;
+  for (uint16_t k = head - n; k != head; k++) {
+    const HANOVER_FLIPDOT_TraceEvent &e =
+        trace_ring[k & (HANOVER_FLIPDOT_TRACE_RING - 1)];
+    out.print((unsigned long)e.t);
+    out.print(' ');
+    out.print((unsigned long)e.event);
+    out.print(' ');
+    out.print((unsigned long)e.a);
+    out.print(' ');
+    out.println((unsigned long)e.b);
+  }
+#else
+  (void)out;
+#endif
+}
+
+// OTHER HARDWARE SETTINGS -------------------------------------------------
+
+/*!
+    @brief  Enable or disable display invert mode (yellow-on-black vs
+            black-on-yellow).
+    @param  i
+            If true, switch to invert mode (black-on-yellow), else normal
+            mode (yellow-on-black).
+    @return None (void).
+    @note   Flipdots have no hardware invert, so this is a flag applied as
+            the buffer is compared against the panel; buffer contents and
+            getPixel() are unchanged. Like drawing, it takes effect on the
+            next display(), which pulses only dots whose displayed state
+            actually changes.
+*/
+void Adafruit_HANOVER_FLIPDOT::invertDisplay(bool i) {
+  invert_mask = i ? 0xFF : 0x00;
+}
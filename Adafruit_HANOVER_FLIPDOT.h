@@ -80,6 +80,161 @@
 #define HANOVER_FLIPDOT_ACTIVATE_SCROLL 0x2F                      ///< Start scroll
 #define HANOVER_FLIPDOT_SET_VERTICAL_SCROLL_AREA 0xA3             ///< Set scroll range
 
+#define HANOVER_FLIPDOT_COUNTER_STEPS 128 ///< CD4024 is 7 stages, wraps at 128
+
+#ifndef HANOVER_FLIPDOT_ADVANCE_US
+#define HANOVER_FLIPDOT_ADVANCE_US 20 ///< Counter advance pulse high/low time
+#endif
+#ifndef HANOVER_FLIPDOT_RESET_US
+#define HANOVER_FLIPDOT_RESET_US 20 ///< Counter reset pulse width
+#endif
+#ifndef HANOVER_FLIPDOT_SETTLE_US
+#define HANOVER_FLIPDOT_SETTLE_US 50 ///< set_pin settle before a coil pulse
+#endif
+#ifndef HANOVER_FLIPDOT_COIL_US
+#define HANOVER_FLIPDOT_COIL_US 500 ///< Coil pulse width
+#endif
+#ifndef HANOVER_FLIPDOT_BOOT_US
+#define HANOVER_FLIPDOT_BOOT_US 1000 ///< Power-up wait before begin()'s reset
+#endif
+#ifndef HANOVER_FLIPDOT_BOOT_RESET_US
+#define HANOVER_FLIPDOT_BOOT_RESET_US 10000 ///< begin()'s reset pulse width
+#endif
+#define HANOVER_FLIPDOT_RESET_COST 1 ///< Counter reset cost in advance pulses
+
+#define HANOVER_FLIPDOT_OP_AND 0 ///< combineBuffer(): keep dots set in both
+#define HANOVER_FLIPDOT_OP_OR 1  ///< combineBuffer(): set dots set in either
+#define HANOVER_FLIPDOT_OP_XOR 2 ///< combineBuffer(): flip dots set in source
+
+#ifndef HANOVER_FLIPDOT_COW_SLOTS
+#define HANOVER_FLIPDOT_COW_SLOTS 4 ///< Max page copies for copy-on-write
+#endif
+#define HANOVER_FLIPDOT_COW_FREE 0xFF ///< cow_page[] value of an unused slot
+
+#ifndef HANOVER_FLIPDOT_GOVERNOR_SHIFT
+#define HANOVER_FLIPDOT_GOVERNOR_SHIFT 2 ///< Newest refresh weighs 1/2^n in getFrameInterval()
+#endif
+
+#ifndef HANOVER_FLIPDOT_TRACE_RING
+#define HANOVER_FLIPDOT_TRACE_RING 0 ///< Trace ring entries (power of 2), 0 compiles tracing out
+#endif
+#ifndef HANOVER_FLIPDOT_TRACE_CLOCK
+#define HANOVER_FLIPDOT_TRACE_CLOCK() micros() ///< Trace timestamp source, e.g. a cycle counter
+#endif
+#if HANOVER_FLIPDOT_TRACE_RING
+#define HANOVER_FLIPDOT_TRACE(event, a, b)                                     \
+  Adafruit_HANOVER_FLIPDOT::traceEvent(event, a, b) ///< Record a trace point
+#else
+#define HANOVER_FLIPDOT_TRACE(event, a, b)                                     \
+  do {                                                                         \
+  } while (0) ///< Tracing compiled out
+#endif
+
+#define HANOVER_FLIPDOT_EV_PIXEL 0   ///< drawPixel(): a = x, b = y
+#define HANOVER_FLIPDOT_EV_CLEAR 1   ///< clearDisplay()
+#define HANOVER_FLIPDOT_EV_DISPLAY 2 ///< display()/displayRegion() called: a = priority
+#define HANOVER_FLIPDOT_EV_SCAN 3    ///< Refresh pass starts: a = first row, b = last row
+#define HANOVER_FLIPDOT_EV_ROW 4     ///< Refresh scans a row: a = row
+#define HANOVER_FLIPDOT_EV_PREEMPT 5 ///< Refresh pass preempted: a = row
+#define HANOVER_FLIPDOT_EV_DONE 6    ///< Refresh pass complete
+
+#ifndef HANOVER_FLIPDOT_TEXT_CACHE_SIZE
+#define HANOVER_FLIPDOT_TEXT_CACHE_SIZE 8 ///< Entries in the text extent cache
+#endif
+
+/*!
+    @brief  One entry of the text extent cache. A string is identified by
+            its hash and length together with the font, text size,
+            rotation, wrap and CP437 settings it was measured with.
+*/
+typedef struct {
+  uint32_t hash;        ///< FNV-1a hash of the string
+  uint16_t len;         ///< String length in bytes, 0 marks an empty slot
+  const GFXfont *font;  ///< Font in use when measured, NULL for classic font
+  uint8_t size_x;       ///< Horizontal text size when measured
+  uint8_t size_y;       ///< Vertical text size when measured
+  uint8_t rotation;     ///< Display rotation when measured
+  uint8_t flags;        ///< Text wrap (bit 0) and CP437 (bit 1) when measured
+  uint16_t w;           ///< Cached width in pixels
+  uint16_t h;           ///< Cached height in pixels
+} HANOVER_FLIPDOT_TextExtent;
+
+class HANOVER_FLIPDOT_Persist;
+class HANOVER_FLIPDOT_VCDTrace;
+
+uint16_t HANOVER_FLIPDOT_crc16(const uint8_t *data, uint16_t n,
+                               uint16_t crc = 0xFFFF);
+
+/*!
+    @brief  Drive timing for one panel, in microseconds. Panel generations
+            and supply voltages differ; pass one of the profiles below, or
+            your own, to setTiming().
+*/
+typedef struct {
+  uint16_t advance_us;    ///< Counter advance pulse high and low time
+  uint16_t reset_us;      ///< Counter reset pulse width
+  uint16_t settle_us;     ///< set_pin settle time before a coil pulse
+  uint16_t coil_us;       ///< Coil pulse width
+  uint16_t boot_us;       ///< Power-up wait before begin()'s reset
+  uint16_t boot_reset_us; ///< begin()'s reset pulse width
+} HANOVER_FLIPDOT_Timing;
+
+/// Conservative timing that works on every panel tested (the default).
+constexpr HANOVER_FLIPDOT_Timing HANOVER_FLIPDOT_TIMING_DEFAULT = {
+    HANOVER_FLIPDOT_ADVANCE_US, HANOVER_FLIPDOT_RESET_US,
+    HANOVER_FLIPDOT_SETTLE_US,  HANOVER_FLIPDOT_COIL_US,
+    HANOVER_FLIPDOT_BOOT_US,    HANOVER_FLIPDOT_BOOT_RESET_US};
+
+/// Short pulses for newer panels on a stiff supply. CD4024 counters
+/// clock in well under a microsecond; check coil_us on the actual panel.
+constexpr HANOVER_FLIPDOT_Timing HANOVER_FLIPDOT_TIMING_FAST = {2,  2,   10,
+                                                               200, 100, 100};
+
+/*!
+    @brief  Predicted cost of a refresh, from estimateRefresh().
+*/
+typedef struct {
+  uint16_t dots;     ///< Dots that would be pulsed (exact)
+  uint16_t resets;   ///< Counter resets (estimate)
+  uint32_t advances; ///< Row plus column counter advance pulses (estimate)
+  uint32_t us;       ///< Refresh time in microseconds (estimate)
+} HANOVER_FLIPDOT_RefreshCost;
+
+/*!
+    @brief  One entry of a wear report, from getHottestDots().
+*/
+typedef struct {
+  uint8_t x;       ///< Column, unrotated
+  uint8_t y;       ///< Row, unrotated (top row of the group when grouped)
+  uint32_t pulses; ///< Coil pulses counted
+} HANOVER_FLIPDOT_Wear;
+
+/*!
+    @brief  Page renderer for streaming mode, see setRenderer().
+    @param  page
+            Page (band of 8 rows) to render, unrotated.
+    @param  state
+            What to render, as passed to displayState(): for instance a
+            scroll offset or the minute of a clock face.
+    @param  out
+            WIDTH bytes to fill, one per column, least significant bit on
+            the topmost row of the page (getBuffer() layout of one page).
+    @param  ctx
+            Pointer given to setRenderer().
+*/
+typedef void (*HANOVER_FLIPDOT_Render)(uint8_t page, uint32_t state,
+                                       uint8_t *out, void *ctx);
+
+/*!
+    @brief  One entry of the trace ring, see HANOVER_FLIPDOT_TRACE_RING.
+*/
+typedef struct {
+  uint32_t t;    ///< HANOVER_FLIPDOT_TRACE_CLOCK() when recorded
+  uint8_t event; ///< HANOVER_FLIPDOT_EV_* code
+  uint8_t a;     ///< First event argument
+  uint8_t b;     ///< Second event argument
+} HANOVER_FLIPDOT_TraceEvent;
+
 /*!
     @brief  Class that stores state and functions for interacting with
             HANOVER_FLIPDOT OLED displays.
@@ -91,20 +246,131 @@ public:
 
   ~Adafruit_HANOVER_FLIPDOT(void);
 
-  bool begin(bool reset = true, uint8_t display_idx = 1);
-  void display(void);
+  bool begin(bool reset = true, uint8_t display_idx = 1, bool wipe = false);
+  void setTiming(const HANOVER_FLIPDOT_Timing &t);
+  const HANOVER_FLIPDOT_Timing &getTiming(void);
+  void display(uint8_t priority = 0);
+  void displayRegion(int16_t x, int16_t y, int16_t w, int16_t h,
+                     uint8_t priority = 0);
+  bool markUnknown(int16_t x, int16_t y, int16_t w, int16_t h);
+  bool anyUnknown(void);
+  void setCheckpointInterval(uint16_t advances);
+  bool enableWearTracking(bool grouped = false);
+  uint32_t getWear(uint8_t x, uint8_t y);
+  uint32_t getTotalPulses(void);
+  uint8_t getHottestDots(HANOVER_FLIPDOT_Wear *out, uint8_t n);
+  uint32_t *getWearTable(uint16_t *entries);
+  bool enableExercise(uint16_t pulses_per_minute);
+  uint16_t exercise(void);
+  static void traceEvent(uint8_t event, uint8_t a, uint8_t b);
+  static void dumpTrace(Print &out);
+#if !defined(ARDUINO)
+  void setPinTrace(HANOVER_FLIPDOT_VCDTrace *t);
+#endif
+  bool redriveSegment(void);
+  uint32_t getFrameInterval(void);
+  void estimateRefresh(HANOVER_FLIPDOT_RefreshCost *cost,
+                       const uint8_t *frame = NULL);
   void clearDisplay(void);
   void invertDisplay(bool i);
   void drawPixel(int16_t x, int16_t y, uint16_t color);
   bool getPixel(int16_t x, int16_t y);
   uint8_t *getBuffer(void);
+  bool enableTripleBuffering(void);
+  void commitFrame(uint8_t priority = 0);
+  bool displayLatest(void);
+  bool enableCopyOnWrite(uint8_t pages);
+  bool requestDisplay(void);
+  bool serviceDisplay(void);
+  void setRenderer(HANOVER_FLIPDOT_Render render, void *ctx = NULL);
+  void displayState(uint32_t state);
+  void shiftUp(uint8_t n, uint16_t color = HANOVER_FLIPDOT_BLACK);
+  void shiftDown(uint8_t n, uint16_t color = HANOVER_FLIPDOT_BLACK);
+  void shiftLeft(uint8_t n, uint16_t color = HANOVER_FLIPDOT_BLACK);
+  void shiftRight(uint8_t n, uint16_t color = HANOVER_FLIPDOT_BLACK);
+  void maskRegion(int16_t x, int16_t y, int16_t w, int16_t h);
+  void invertRegion(int16_t x, int16_t y, int16_t w, int16_t h);
+  void combineBuffer(const uint8_t *src, uint8_t op);
+  void combineBitmap(const uint8_t *bitmap, uint8_t op);
+  void getTextExtent(const char *str, uint16_t *w, uint16_t *h);
+  uint16_t getTextAdvance(const char *str);
+  void clearTextCache(void);
 
 protected:
   inline void SPIwrite(uint8_t d) __attribute__((always_inline));
   void HANOVER_FLIPDOT_command1(uint8_t c);
   void HANOVER_FLIPDOT_commandList(const uint8_t *c, uint8_t n);
+  uint8_t pageRows(uint8_t page);
+  bool clipRegion(int16_t *x, int16_t *y, int16_t *w, int16_t *h);
+  void clearPadding(void);
+  const uint8_t *readablePage(uint8_t page);
+  uint8_t *writablePage(uint8_t page);
+  void commitPage(uint8_t slot);
+  bool commitPages(void);
+  bool refreshDot(uint8_t x, uint8_t y);
+  void timeRefresh(uint32_t start);
+  void scan(uint8_t priority, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+  bool refresh(const uint8_t *frame, uint8_t x0, uint8_t y0, uint8_t x1,
+               uint8_t y1);
+  void sweep(bool on);
+  void selectPanel(void);
+  void moveTo(uint8_t col, uint8_t row);
+  bool wantReset(uint8_t col, uint8_t row, uint8_t dc, uint8_t dr,
+                 uint16_t since);
+  void advance(int8_t pin, uint8_t n);
+  void resetCounters(void);
+  void pulseDot(bool on);
+  void pinWrite(int8_t pin, uint8_t value);
+  void wait(uint32_t us);
 
   uint8_t *buffer; ///< Buffer data used for display buffer. Allocated when begin method is called.
+  uint8_t *shadow; ///< Dot state last driven to the panel, same layout as buffer. Allocated when begin method is called.
+  uint8_t *frames[3]; ///< All three frames once enableTripleBuffering() succeeds, else NULL.
+  uint8_t back_idx;  ///< frames[] index being drawn into (== buffer). Drawing side only.
+  uint8_t front_idx; ///< frames[] index last displayed. Refresh side only.
+  uint8_t handoff;   ///< frames[] index waiting to be displayed, plus HANOVER_FLIPDOT_FRESH flag. Atomic.
+  uint8_t *cow_pool;  ///< cow_slots page copies of WIDTH bytes, or NULL.
+  uint8_t cow_slots;  ///< Number of page copies in cow_pool.
+  uint8_t cow_used;   ///< Slots of cow_page[] holding a page. Drawing side only.
+  uint8_t cow_page[HANOVER_FLIPDOT_COW_SLOTS]; ///< Page held by each copy, or HANOVER_FLIPDOT_COW_FREE. Drawing side only.
+  uint8_t cow_active;   ///< Non-zero from requestDisplay() until serviceDisplay() finishes. Atomic.
+  uint8_t refresh_page; ///< Pages below this are done for the current requestDisplay() pass. Atomic.
+  uint8_t preempt;    ///< Priority + 1 of the most urgent refresh request not yet picked up, 0 if none. Atomic.
+  uint8_t scan_level; ///< preempt value the running scan serves; a higher request aborts it. 0xFF: not preemptible.
+  uint8_t scanning;   ///< Non-zero while display() or displayRegion() is driving the panel. Atomic.
+  uint32_t refresh_us;    ///< Smoothed duration of recent refreshes, see getFrameInterval().
+  HANOVER_FLIPDOT_Timing timing; ///< Drive timing, see setTiming().
+  uint16_t checkpoint_every; ///< Max advance pulses between counter resets, 0 for no limit.
+  uint16_t since_reset; ///< Advance pulses since the last counter reset.
+  uint8_t seg_lo; ///< Lowest row addressed since the last reset (0xFF: none).
+  uint8_t seg_hi; ///< Highest row addressed since the last reset.
+  uint32_t *wear;        ///< Coil pulses per dot, or per 8-dot page column when wear_grouped. NULL until enableWearTracking().
+  bool wear_grouped;     ///< wear[] has one counter per buffer byte rather than per dot.
+  uint32_t total_pulses; ///< Coil pulses since construction.
+  uint8_t *touched;        ///< Bit per 8-dot group pulsed by a refresh since the exercise last passed it. NULL unless exercising.
+  uint16_t exercise_rate;  ///< Exercise budget, pulses per minute.
+  uint32_t exercise_tokens; ///< Exercise pulses earned, times 60000.
+  uint32_t exercise_ms;    ///< millis() when tokens were last earned.
+  uint8_t exercise_x;      ///< Next dot the exercise looks at (column).
+  uint8_t exercise_y;      ///< Next dot the exercise looks at (row).
+  bool exercising;         ///< Pulses are exercise, not changes.
+#if !defined(ARDUINO)
+  HANOVER_FLIPDOT_VCDTrace *trace; ///< Pin trace fed by pinWrite() and wait(), or NULL. Host builds only.
+#endif
+  HANOVER_FLIPDOT_Render render; ///< Page renderer in streaming mode, else NULL.
+  void *render_ctx;     ///< Passed to render.
+  uint8_t *render_page; ///< Streaming mode: target page, then shown page (2 * WIDTH bytes).
+  uint32_t render_state; ///< State the panel was last rendered from.
+  uint8_t render_inv;    ///< invert_mask the panel was last rendered with.
+  bool render_blank;     ///< Panel is blank (after begin()), render_state means nothing.
+  bool render_unknown;   ///< Panel state unknown: the next displayState() drives every dot.
+  uint8_t *unknown; ///< Dots whose physical state is not known (set bit), same layout as buffer. NULL until markUnknown().
+  HANOVER_FLIPDOT_Persist *persist; ///< Non-volatile state store, or NULL.
+  uint8_t persisted; ///< Non-zero while the panel matches the stored state.
+  uint8_t invert_mask; ///< 0xFF while invertDisplay(true) is in effect, else 0x00.
+  uint8_t panel_idx; ///< Which enable pin (1-4) selects this panel. Set by begin().
+  uint8_t col_idx; ///< Current value of the column counter.
+  uint8_t row_idx; ///< Current value of the row counter.
 
   int8_t reset_pin;          ///< The pin used to reset both row and col binary counters. Set during construction.
   int8_t row_adv_pin;        ///< The pin used to advance the row. Set during construction.
@@ -115,3 +381,24 @@ protected:
   int8_t disp2_enable_pin;   ///< The pin used to select display 2. Set during construction.
   int8_t disp3_enable_pin;   ///< The pin used to select display 3. Set during construction.
   int8_t disp4_enable_pin;   ///< The pin used to select display 4. Set during construction.
+
+  HANOVER_FLIPDOT_TextExtent text_cache[HANOVER_FLIPDOT_TEXT_CACHE_SIZE]; ///< Recently measured strings
+  uint8_t text_cache_next;   ///< Next text_cache slot to replace, round robin.
+
+  friend class HANOVER_FLIPDOT_Ticker;
+  friend class HANOVER_FLIPDOT_Transition;
+  friend class HANOVER_FLIPDOT_Tiled;
+  friend class HANOVER_FLIPDOT_Persist;
+  friend class HANOVER_FLIPDOT_VCDTrace;
+  friend class HANOVER_FLIPDOT_Link;
+  friend class HANOVER_FLIPDOT_Bus;
+
+  static Adafruit_HANOVER_FLIPDOT *selected; ///< Panel whose enable pin is currently high
+#if HANOVER_FLIPDOT_TRACE_RING
+  static HANOVER_FLIPDOT_TraceEvent trace_ring[HANOVER_FLIPDOT_TRACE_RING]; ///< Trace ring, shared by all panels
+  static uint16_t trace_head; ///< Entries recorded so far (wraps). Atomic.
+  static uint16_t trace_tail; ///< Index of the oldest entry kept (wraps). Atomic.
+#endif
+};
+
+#endif // _Adafruit_HANOVER_FLIPDOT_H_
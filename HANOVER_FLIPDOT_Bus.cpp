@@ -0,0 +1,211 @@
+/*!
+ * @file HANOVER_FLIPDOT_Bus.cpp
+ *
+ * Hanover controller protocol parser for Adafruit_HANOVER_FLIPDOT. It takes
+ * one character at a time, so frames may arrive in any fragments, and
+ * decodes data bytes into the display buffer as they come in.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "HANOVER_FLIPDOT_Bus.h"
+
+#define BUS_IDLE 0       ///< Waiting for STX
+#define BUS_ADDRESS 1    ///< Address digits
+#define BUS_RESOLUTION 2 ///< Resolution digits
+#define BUS_DATA 3       ///< Data digits, up to ETX
+#define BUS_CHECKSUM 4   ///< Checksum digits
+
+/*!
+    @brief  Constructor for a Hanover protocol receiver.
+    @param  display
+            Display to write to. Call its begin() (and, to keep decoding
+            and refreshing on separate cores, enableTripleBuffering())
+            first.
+    @param  io
+            Stream frames arrive on, e.g. &Serial1 behind an RS-485
+            transceiver (typically 4800 baud, 8N1).
+    @param  address
+            Address byte (as sent, e.g. 0x11 for a sign whose address
+            switch is at 1) of the frames to show. Default if unspecified
+            is HANOVER_FLIPDOT_BUS_ANY.
+    @return HANOVER_FLIPDOT_Bus object.
+*/
+HANOVER_FLIPDOT_Bus::HANOVER_FLIPDOT_Bus(Adafruit_HANOVER_FLIPDOT *display,
+                                         Stream *io, uint8_t address)
+    : display(display), io(io), received(0), rejected(0), count(0),
+      address(address), state(BUS_IDLE), sum(0), value(0), digits(0),
+      shown(0xFF) {
+  field[0] = field[1] = 0;
+  stale[0] = stale[1] = stale[2] = display->WIDTH; // May start out different
+}
+
+/*!
+    @brief  Take in everything waiting on the Stream. Call from loop().
+    @return Number of frames shown by this call.
+*/
+uint16_t HANOVER_FLIPDOT_Bus::poll(void) {
+  uint16_t n = 0;
+  while (io->available() > 0) {
+    int c = io->read();
+    if (c < 0)
+      break;
+    n += feed(c);
+  }
+  return n;
+}
+
+/*!
+    @brief  Take in one character, for callers that read the Stream
+            themselves (e.g. from a recorded capture).
+    @param  c
+            Character received.
+    @return true if it completed a frame that was shown.
+*/
+bool HANOVER_FLIPDOT_Bus::feed(uint8_t c) {
+  if (c == HANOVER_FLIPDOT_BUS_STX) {
+    if (state > BUS_ADDRESS) // Ours, but cut short
+      reject();
+    state = BUS_ADDRESS;
+    sum = value = digits = 0;
+    count = 0;
+    return false;
+  }
+  if (state == BUS_IDLE)
+    return false;
+  if (state != BUS_CHECKSUM)
+    sum += c;
+  if ((c == HANOVER_FLIPDOT_BUS_ETX) && (state == BUS_DATA) && !digits) {
+    state = BUS_CHECKSUM;
+    return false;
+  }
+  uint8_t n;
+  if ((c >= '0') && (c <= '9'))
+    n = c - '0';
+  else if ((c >= 'A') && (c <= 'F'))
+    n = c - 'A' + 10;
+  else if ((c >= 'a') && (c <= 'f'))
+    n = c - 'a' + 10;
+  else {
+    if (state > BUS_ADDRESS)
+      reject();
+    state = BUS_IDLE;
+    return false;
+  }
+  value = (value << 4) | n;
+  if (++digits < 2)
+    return false;
+  digits = 0;
+  switch (state) {
+  case BUS_ADDRESS:
+    field[0] = value;
+    if ((address == HANOVER_FLIPDOT_BUS_ANY) || (value == address))
+      state = BUS_RESOLUTION;
+    else
+      state = BUS_IDLE; // Another sign's frame
+    return false;
+  case BUS_RESOLUTION:
+    field[1] = value;
+    state = BUS_DATA;
+    return false;
+  case BUS_DATA:
+    store(value);
+    return false;
+  default: // BUS_CHECKSUM
+    state = BUS_IDLE;
+    if ((uint8_t)(sum + value) || ((uint8_t)count != field[1])) {
+      reject();
+      return false;
+    }
+    commit();
+    received++;
+    return true;
+  }
+}
+
+/*!
+    @brief  Count of frames shown since construction.
+    @return Number of frames.
+*/
+uint32_t HANOVER_FLIPDOT_Bus::framesReceived(void) { return received; }
+
+/*!
+    @brief  Count of frames for this address that were cut short, held
+            something other than hex digits, or failed the checksum or the
+            length check, since construction.
+    @return Number of frames.
+*/
+uint32_t HANOVER_FLIPDOT_Bus::framesRejected(void) { return rejected; }
+
+/*!
+    @brief  Put one data byte where it belongs in the buffer. Bytes beyond
+            the panel are counted (for the length check) and dropped.
+    @param  b
+            Eight dots of one column, least significant bit topmost.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Bus::store(uint8_t b) {
+  uint8_t pages = (display->HEIGHT + 7) / 8;
+  if (count < display->WIDTH * pages)
+    display->writablePage(count % pages)[count / pages] = b;
+  count++;
+}
+
+/*!
+    @brief  Count a rejected frame and put the columns it wrote back to
+            the last good picture, so no refresh can show them.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Bus::reject(void) {
+  rejected++;
+  uint8_t pages = (display->HEIGHT + 7) / 8;
+  uint16_t cols = (count + pages - 1) / pages;
+  if (cols > display->WIDTH)
+    cols = display->WIDTH;
+  // With triple buffering, the frame last committed is the good picture;
+  // otherwise (or before any commit) it is what the panel shows.
+  bool slot = display->frames[1] && (shown != 0xFF);
+  const uint8_t *src = slot ? display->frames[shown] : display->shadow;
+  uint8_t flip = slot ? 0 : display->invert_mask;
+  for (uint8_t p = 0; cols && (p < pages); p++) {
+    uint8_t *dst = display->writablePage(p);
+    const uint8_t *from = src + p * display->WIDTH;
+    for (uint8_t x = 0; x < cols; x++)
+      dst[x] = from[x] ^ flip;
+  }
+}
+
+/*!
+    @brief  Show the frame. With triple buffering it is committed, and the
+            new back frame is brought up to date by copying only the
+            columns it missed while other slots were written, so a frame
+            narrower than the panel leaves the rest of the picture as it
+            was either way; otherwise the columns it covered are
+            refreshed.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Bus::commit(void) {
+  uint8_t pages = (display->HEIGHT + 7) / 8;
+  uint16_t cols = (count + pages - 1) / pages;
+  if (cols > display->WIDTH)
+    cols = display->WIDTH;
+  if (display->frames[1]) {
+    shown = display->back_idx;
+    display->commitFrame();
+    for (uint8_t i = 0; i < 3; i++)
+      if (stale[i] < cols)
+        stale[i] = cols;
+    stale[shown] = 0;
+    uint8_t back = display->back_idx;
+    for (uint8_t p = 0; stale[back] && (p < pages); p++)
+      memcpy(display->writablePage(p),
+             display->frames[shown] + p * display->WIDTH, stale[back]);
+    stale[back] = 0;
+  } else if (count) {
+    display->displayRegion(0, 0, cols, display->HEIGHT);
+  }
+}
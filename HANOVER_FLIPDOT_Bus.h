@@ -0,0 +1,81 @@
+/*!
+ * @file HANOVER_FLIPDOT_Bus.h
+ *
+ * Accepts the serial (RS-485) protocol of the original Hanover sign
+ * controllers, so an existing scheduling system can drive an
+ * Adafruit_HANOVER_FLIPDOT panel unchanged.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HANOVER_FLIPDOT_BUS_H_
+#define _HANOVER_FLIPDOT_BUS_H_
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+
+#define HANOVER_FLIPDOT_BUS_STX 0x02 ///< Start of a frame
+#define HANOVER_FLIPDOT_BUS_ETX 0x03 ///< End of the data
+#define HANOVER_FLIPDOT_BUS_ANY 0xFF ///< Address that accepts every frame
+
+/*!
+    @brief  Streaming parser for Hanover controller frames, as documented
+            by the people who have reverse engineered the protocol (the
+            original documentation is not public):
+
+              STX, address (2 ASCII hex digits),
+              resolution (2 ASCII hex digits, data byte count modulo 256),
+              data (2 ASCII hex digits per byte), ETX,
+              checksum (2 ASCII hex digits)
+
+            The data holds the picture column by column, (HEIGHT + 7) / 8
+            bytes per column from the top, least significant bit topmost.
+            The checksum is the two's complement of the sum of every
+            character after STX up to and including ETX, so that sum plus
+            the checksum is 0 modulo 256.
+
+            Decoded bytes go straight into the display buffer (the back
+            frame, with triple buffering); the only RAM used is the parser
+            state. A frame that checks out is shown with the usual diff
+            refresh. One that does not is never shown: the columns it
+            covered are put back to the last good picture (what the panel
+            shows, without triple buffering) as soon as it is rejected.
+            Until then a display() called between poll()s can show part of
+            a frame still arriving; use triple buffering to rule that out.
+            Nothing is sent back: the original signs never answer on the
+            bus.
+*/
+class HANOVER_FLIPDOT_Bus {
+public:
+  HANOVER_FLIPDOT_Bus(Adafruit_HANOVER_FLIPDOT *display, Stream *io,
+                      uint8_t address = HANOVER_FLIPDOT_BUS_ANY);
+
+  uint16_t poll(void);
+  bool feed(uint8_t c);
+  uint32_t framesReceived(void);
+  uint32_t framesRejected(void);
+
+protected:
+  void store(uint8_t b);
+  void reject(void);
+  void commit(void);
+
+  Adafruit_HANOVER_FLIPDOT *display; ///< Display whose buffer is written
+  Stream *io;         ///< Where frames come from
+  uint32_t received;  ///< Frames shown
+  uint32_t rejected;  ///< Frames for this address that failed a check
+  uint16_t count;     ///< Data bytes received in this frame
+  uint8_t address;    ///< Address to answer to, or HANOVER_FLIPDOT_BUS_ANY
+  uint8_t state;      ///< Position in the frame
+  uint8_t sum;        ///< Running checksum
+  uint8_t value;      ///< Byte being assembled from hex digits
+  uint8_t digits;     ///< Hex digits in value so far
+  uint8_t field[2];   ///< Address and resolution of this frame
+  uint8_t shown;      ///< frames[] slot last committed, 0xFF if none
+  uint8_t stale[3];   ///< Columns from 0 each frames[] slot has missed
+};
+
+#endif // _HANOVER_FLIPDOT_BUS_H_
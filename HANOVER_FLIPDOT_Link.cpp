@@ -0,0 +1,261 @@
+/*!
+ * @file HANOVER_FLIPDOT_Link.cpp
+ *
+ * Binary frame protocol receiver for Adafruit_HANOVER_FLIPDOT. The parser
+ * takes one byte at a time, so packets may arrive in any fragments, and
+ * writes payload bytes into the display buffer as they come in.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "HANOVER_FLIPDOT_Link.h"
+
+#define LINK_SYNC0 0   ///< Waiting for HANOVER_FLIPDOT_LINK_SYNC0
+#define LINK_SYNC1 1   ///< Waiting for HANOVER_FLIPDOT_LINK_SYNC1
+#define LINK_TYPE 2    ///< Waiting for the type byte
+#define LINK_RECT 3    ///< Rectangle bytes, LINK_RECT + index
+#define LINK_PAYLOAD 7 ///< Payload bytes
+#define LINK_CRC_LO 8  ///< Low byte of the CRC
+#define LINK_CRC_HI 9  ///< High byte of the CRC
+
+/*!
+    @brief  Grow a rectangle of pages to cover another.
+    @param  r
+            x0, page0, x1, page1 to grow; x0 > x1 if empty.
+    @param  add
+            x0, page0, x1, page1 to cover.
+    @return None (void).
+*/
+static void grow(uint8_t *r, const uint8_t *add) {
+  for (uint8_t i = 0; i < 2; i++) {
+    if (add[i] < r[i])
+      r[i] = add[i];
+    if (add[i + 2] > r[i + 2])
+      r[i + 2] = add[i + 2];
+  }
+}
+
+/*!
+    @brief  Constructor for a protocol receiver.
+    @param  display
+            Display to write to. Call its begin() (and, to keep drawing
+            and refreshing on separate cores, enableTripleBuffering())
+            first.
+    @param  io
+            Stream packets arrive on, e.g. &Serial. Replies are written
+            back to it.
+    @param  timeout_ms
+            A packet with a gap longer than this between two bytes is
+            abandoned. Default if unspecified is 100 ms.
+    @return HANOVER_FLIPDOT_Link object.
+*/
+HANOVER_FLIPDOT_Link::HANOVER_FLIPDOT_Link(Adafruit_HANOVER_FLIPDOT *display,
+                                           Stream *io, uint16_t timeout_ms)
+    : display(display), io(io), timeout_ms(timeout_ms), last_ms(0),
+      received(0), rejected(0), crc(0xFFFF), left(0), state(LINK_SYNC0),
+      type(0), col(0), page(0), discard(false), resync(false) {
+  dirty[0] = dirty[1] = 0xFF;
+  dirty[2] = dirty[3] = 0;
+  for (uint8_t i = 0; i < 3; i++) { // Slots may start out different
+    stale[i][0] = stale[i][1] = 0;
+    stale[i][2] = display->WIDTH - 1;
+    stale[i][3] = (display->HEIGHT + 7) / 8 - 1;
+  }
+}
+
+/*!
+    @brief  Take in everything waiting on the Stream. Call from loop().
+    @return Number of packets accepted by this call.
+*/
+uint16_t HANOVER_FLIPDOT_Link::poll(void) {
+  uint16_t n = 0;
+  if ((state != LINK_SYNC0) && ((uint32_t)(millis() - last_ms) > timeout_ms))
+    finish(false);
+  while (io->available() > 0) {
+    int c = io->read();
+    if (c < 0)
+      break;
+    n += feed(c);
+  }
+  return n;
+}
+
+/*!
+    @brief  Take in one byte, for callers that read the Stream themselves.
+    @param  c
+            Byte received.
+    @return true if it completed a packet that was accepted.
+*/
+bool HANOVER_FLIPDOT_Link::feed(uint8_t c) {
+  last_ms = millis();
+  if ((state >= LINK_TYPE) && (state <= LINK_PAYLOAD))
+    crc = HANOVER_FLIPDOT_crc16(&c, 1, crc);
+  switch (state) {
+  case LINK_SYNC0:
+    if (c == HANOVER_FLIPDOT_LINK_SYNC0)
+      state = LINK_SYNC1;
+    return false;
+  case LINK_SYNC1:
+    state = (c == HANOVER_FLIPDOT_LINK_SYNC1)   ? LINK_TYPE
+            : (c == HANOVER_FLIPDOT_LINK_SYNC0) ? LINK_SYNC1
+                                                : LINK_SYNC0;
+    crc = 0xFFFF;
+    return false;
+  case LINK_TYPE:
+    type = c;
+    if ((c & ~HANOVER_FLIPDOT_LINK_COMMIT) != HANOVER_FLIPDOT_LINK_FRAME) {
+      state = LINK_RECT;
+      return false;
+    }
+    rect[0] = rect[1] = 0;
+    rect[2] = display->WIDTH;
+    rect[3] = (display->HEIGHT + 7) / 8;
+    state = start() ? LINK_PAYLOAD : LINK_CRC_LO;
+    return false;
+  case LINK_PAYLOAD:
+    if (!discard) {
+      // Looked up per byte: copy-on-write may move the page between polls
+      uint8_t *dst = display->writablePage(page) + rect[0] + col;
+      if ((type & ~HANOVER_FLIPDOT_LINK_COMMIT) == HANOVER_FLIPDOT_LINK_XOR)
+        *dst ^= c;
+      else
+        *dst = c;
+    }
+    if (!--left) {
+      state = LINK_CRC_LO;
+    } else if (++col == rect[2]) {
+      col = 0;
+      page++;
+    }
+    return false;
+  case LINK_CRC_LO:
+    left = c;
+    state = LINK_CRC_HI;
+    return false;
+  case LINK_CRC_HI: {
+    bool ok = !discard && (crc == (uint16_t)(left | (c << 8)));
+    finish(ok);
+    return ok;
+  }
+  default: // Rectangle header
+    rect[state - LINK_RECT] = c;
+    if (++state == LINK_PAYLOAD)
+      state = start() ? LINK_PAYLOAD : LINK_CRC_LO;
+    return false;
+  }
+}
+
+/*!
+    @brief  Count of packets accepted since construction.
+    @return Number of packets.
+*/
+uint32_t HANOVER_FLIPDOT_Link::packetsReceived(void) { return received; }
+
+/*!
+    @brief  Count of packets refused (bad CRC, bad rectangle, unknown type,
+            timed out, or waiting for a FRAME) since construction.
+    @return Number of packets.
+*/
+uint32_t HANOVER_FLIPDOT_Link::packetsRejected(void) { return rejected; }
+
+/*!
+    @brief  Header complete: decide whether the payload is kept.
+    @return true if the packet has a payload (kept or not).
+*/
+bool HANOVER_FLIPDOT_Link::start(void) {
+  uint8_t base = type & ~HANOVER_FLIPDOT_LINK_COMMIT;
+  left = rect[2] * rect[3];
+  discard = (base > HANOVER_FLIPDOT_LINK_XOR) ||
+            (resync && (base != HANOVER_FLIPDOT_LINK_FRAME)) ||
+            (rect[0] + rect[2] > display->WIDTH) ||
+            (rect[1] + rect[3] > (display->HEIGHT + 7) / 8);
+  if (!left)
+    return false;
+  col = 0;
+  page = rect[1];
+  if (!discard) {
+    uint8_t r[4] = {rect[0], rect[1], (uint8_t)(rect[0] + rect[2] - 1),
+                    (uint8_t)(rect[1] + rect[3] - 1)};
+    grow(dirty, r);
+  }
+  return true;
+}
+
+/*!
+    @brief  Packet over: reply, and show the result if asked to.
+    @param  ok
+            true if the packet was accepted.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Link::finish(bool ok) {
+  if (ok) {
+    received++;
+    if ((type & ~HANOVER_FLIPDOT_LINK_COMMIT) == HANOVER_FLIPDOT_LINK_FRAME)
+      resync = false;
+    if (type & HANOVER_FLIPDOT_LINK_COMMIT)
+      commit();
+  } else {
+    rejected++;
+    // Part of the payload may already be in the buffer
+    if (!discard && (state >= LINK_PAYLOAD)) {
+      resync = true;
+      if (!display->frames[1])
+        restore(); // The buffer is live; the back frame is not
+    }
+  }
+  io->write(ok ? HANOVER_FLIPDOT_LINK_ACK : HANOVER_FLIPDOT_LINK_NAK);
+  state = LINK_SYNC0;
+}
+
+/*!
+    @brief  Undo a rejected packet without triple buffering: put its
+            rectangle back to what the panel shows, so no display() can
+            show the bad payload.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Link::restore(void) {
+  for (uint8_t p = rect[1]; p < rect[1] + rect[3]; p++) {
+    uint8_t *dst = display->writablePage(p) + rect[0];
+    const uint8_t *src = display->shadow + p * display->WIDTH + rect[0];
+    for (uint8_t i = 0; i < rect[2]; i++)
+      dst[i] = src[i] ^ display->invert_mask;
+  }
+}
+
+/*!
+    @brief  Show the buffer. With triple buffering the frame is committed
+            and the new back frame is brought up to date by copying just
+            the rectangles it missed while other slots were drawn into, so
+            later patches and deltas apply to what was just shown;
+            otherwise the part of the panel written since the last commit
+            is refreshed.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Link::commit(void) {
+  if (display->frames[1]) {
+    uint8_t shown = display->back_idx;
+    display->commitFrame();
+    for (uint8_t i = 0; i < 3; i++)
+      grow(stale[i], dirty);
+    stale[shown][0] = stale[shown][1] = 0xFF;
+    stale[shown][2] = stale[shown][3] = 0;
+    uint8_t *r = stale[display->back_idx];
+    const uint8_t *src = display->frames[shown];
+    for (uint8_t p = r[1]; (r[0] <= r[2]) && (p <= r[3]); p++)
+      memcpy(display->writablePage(p) + r[0], src + p * display->WIDTH + r[0],
+             r[2] - r[0] + 1);
+    r[0] = r[1] = 0xFF;
+    r[2] = r[3] = 0;
+  } else if (dirty[0] <= dirty[2]) {
+    display->displayRegion(dirty[0], dirty[1] * 8, dirty[2] - dirty[0] + 1,
+                           (dirty[3] - dirty[1] + 1) * 8);
+  } else {
+    display->display(); // Nothing new from the link; show any GFX drawing
+  }
+  dirty[0] = dirty[1] = 0xFF;
+  dirty[2] = dirty[3] = 0;
+}
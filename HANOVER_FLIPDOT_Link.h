@@ -0,0 +1,93 @@
+/*!
+ * @file HANOVER_FLIPDOT_Link.h
+ *
+ * Compact binary frame protocol for pushing pictures to an
+ * Adafruit_HANOVER_FLIPDOT panel from a host over a serial line.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HANOVER_FLIPDOT_LINK_H_
+#define _HANOVER_FLIPDOT_LINK_H_
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+
+#define HANOVER_FLIPDOT_LINK_SYNC0 0xF1 ///< First byte of every packet
+#define HANOVER_FLIPDOT_LINK_SYNC1 0xD0 ///< Second byte of every packet
+#define HANOVER_FLIPDOT_LINK_FRAME 0x00 ///< Packet type: full frame
+#define HANOVER_FLIPDOT_LINK_PATCH 0x01 ///< Packet type: replace a rectangle
+#define HANOVER_FLIPDOT_LINK_XOR 0x02   ///< Packet type: XOR into a rectangle
+#define HANOVER_FLIPDOT_LINK_COMMIT 0x80 ///< Type flag: show the result
+#define HANOVER_FLIPDOT_LINK_ACK 0x06    ///< Reply to a good packet
+#define HANOVER_FLIPDOT_LINK_NAK 0x15    ///< Reply to a rejected packet
+
+/*!
+    @brief  Receives pictures in getBuffer() layout over a Stream and shows
+            them. Each packet is
+
+              0xF1 0xD0, type,
+              x, page, w, pages       (PATCH and XOR only),
+              payload,                (w bytes per page, page by page)
+              CRC-16 (little-endian)  (HANOVER_FLIPDOT_crc16() from type on)
+
+            A FRAME carries the whole buffer, a PATCH replaces a rectangle
+            of whole pages and an XOR delta flips the set bits in one. With
+            the COMMIT flag in type the panel is then refreshed, which only
+            pulses the dots that really changed. Every packet is answered
+            with ACK or NAK.
+
+            Payload bytes go straight from the Stream into the display's
+            buffer, so the only RAM used is the parser state. With triple
+            buffering that is the back frame, which nothing shows before a
+            good COMMIT. Without it, a display() called between poll()s
+            can show part of a packet still arriving, and a packet that
+            fails its CRC is undone by putting its rectangle back to what
+            the panel shows. Either way everything but a FRAME is then
+            refused until a good FRAME arrives.
+
+            With triple buffering the link remembers which rectangles each
+            frame slot has missed, and on COMMIT brings the new back frame
+            up to date by copying only those, so deltas always apply to
+            the picture last sent. Drawing into the display from outside
+            the link is not carried over this way.
+*/
+class HANOVER_FLIPDOT_Link {
+public:
+  HANOVER_FLIPDOT_Link(Adafruit_HANOVER_FLIPDOT *display, Stream *io,
+                       uint16_t timeout_ms = 100);
+
+  uint16_t poll(void);
+  bool feed(uint8_t c);
+  uint32_t packetsReceived(void);
+  uint32_t packetsRejected(void);
+
+protected:
+  bool start(void);
+  void finish(bool ok);
+  void commit(void);
+  void restore(void);
+
+  Adafruit_HANOVER_FLIPDOT *display; ///< Display whose buffer is written
+  Stream *io;          ///< Where packets come from and replies go
+  uint16_t timeout_ms; ///< Silence that abandons a half-received packet
+  uint32_t last_ms;    ///< millis() when the last byte arrived
+  uint32_t received;   ///< Packets accepted
+  uint32_t rejected;   ///< Packets refused
+  uint16_t crc;        ///< Running CRC of the packet so far
+  uint16_t left;       ///< Payload bytes still to come
+  uint8_t state;       ///< Position in the packet
+  uint8_t type;        ///< Type byte of the packet being received
+  uint8_t rect[4];     ///< x, page, w, pages of the packet being received
+  uint8_t col;         ///< Column offset of the next payload byte in rect
+  uint8_t page;        ///< Page of the next payload byte
+  uint8_t dirty[4];    ///< x0, page0, x1, page1 written since the last commit
+  uint8_t stale[3][4]; ///< Same, per triple-buffer slot: behind the picture
+  bool discard;        ///< Packet is refused, its payload is skipped
+  bool resync;         ///< Buffer content unknown, only a FRAME is accepted
+};
+
+#endif // _HANOVER_FLIPDOT_LINK_H_
@@ -0,0 +1,205 @@
+/*!
+ * @file HANOVER_FLIPDOT_Persist.cpp
+ *
+ * Non-volatile copy of an Adafruit_HANOVER_FLIPDOT panel's dot state.
+ * Record layout at addr: 'H', 'F', WIDTH, HEIGHT, CRC-16 of the state
+ * (little-endian), then the state in getBuffer() layout. The magic is
+ * written last and cleared first, so a record is only ever valid when
+ * it is complete and matches the panel.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "HANOVER_FLIPDOT_Persist.h"
+
+/*!
+    @brief  Constructor for a state store. Construct it before calling the
+            display's begin(), which is where the state is restored.
+    @param  display
+            Display whose dot state to keep. Only one store per display.
+    @param  addr
+            Offset of the record in non-volatile memory. Give each panel
+            of a tiled sign its own, size() bytes apart.
+    @param  interval_ms
+            Minimum time between two saves. Changes in between are merged
+            into the next save. Default if unspecified is one minute.
+    @return HANOVER_FLIPDOT_Persist object.
+*/
+HANOVER_FLIPDOT_Persist::HANOVER_FLIPDOT_Persist(
+    Adafruit_HANOVER_FLIPDOT *display, uint16_t addr, uint32_t interval_ms)
+    : display(display), addr(addr), interval_ms(interval_ms), last_ms(0),
+      started(false) {
+  display->persist = this;
+}
+
+/*!
+    @brief  Destructor, detaches from the display.
+*/
+HANOVER_FLIPDOT_Persist::~HANOVER_FLIPDOT_Persist(void) {
+  if (display->persist == this)
+    display->persist = NULL;
+}
+
+/*!
+    @brief  Get the size of the record.
+    @return Bytes of non-volatile memory used from addr on.
+*/
+uint16_t HANOVER_FLIPDOT_Persist::size(void) {
+  return HANOVER_FLIPDOT_PERSIST_HEADER +
+         display->WIDTH * ((display->HEIGHT + 7) / 8);
+}
+
+/*!
+    @brief  Save the dot state if it changed since the last save and the
+            interval has passed. Call regularly, e.g. after display().
+    @return true if the state was written, false otherwise.
+    @note   Call from the context that refreshes the panel, never while a
+            refresh is running elsewhere.
+*/
+bool HANOVER_FLIPDOT_Persist::update(void) {
+  if (display->persisted || !display->shadow ||
+      ((uint32_t)(millis() - last_ms) < interval_ms))
+    return false;
+  return save();
+}
+
+/*!
+    @brief  Save the dot state now, regardless of the interval.
+    @return true if the state was written, false if the display has not
+            been started, has dots marked unknown, or the backend failed.
+    @note   Only bytes that differ from what is stored are written, and
+            flash-emulated EEPROM is committed once per save.
+*/
+bool HANOVER_FLIPDOT_Persist::save(void) {
+  if (!display->shadow || display->anyUnknown() || !begin())
+    return false;
+  uint16_t n = size() - HANOVER_FLIPDOT_PERSIST_HEADER, crc = checksum();
+  write(addr, 0); // Invalid until complete
+  for (uint16_t i = 0; i < n; i++)
+    write(addr + HANOVER_FLIPDOT_PERSIST_HEADER + i, display->shadow[i]);
+  write(addr + 2, display->WIDTH);
+  write(addr + 3, display->HEIGHT);
+  write(addr + 4, crc & 0xFF);
+  write(addr + 5, crc >> 8);
+  write(addr + 1, 'F');
+  write(addr, 'H');
+  commit();
+  display->persisted = 1;
+  last_ms = millis();
+  return true;
+}
+
+/*!
+    @brief  Read the saved state into the display's shadow, checking it.
+    @return true if a valid record for this panel size was restored,
+            false if the display must be swept instead.
+    @note   Called by the display's begin().
+*/
+bool HANOVER_FLIPDOT_Persist::load(void) {
+  if (!begin() || (read(addr) != 'H') || (read(addr + 1) != 'F') ||
+      (read(addr + 2) != display->WIDTH) ||
+      (read(addr + 3) != display->HEIGHT))
+    return false;
+  uint16_t n = size() - HANOVER_FLIPDOT_PERSIST_HEADER;
+  for (uint16_t i = 0; i < n; i++)
+    display->shadow[i] = read(addr + HANOVER_FLIPDOT_PERSIST_HEADER + i);
+  if (checksum() != (read(addr + 4) | (read(addr + 5) << 8)))
+    return false;
+  display->persisted = 1;
+  last_ms = millis();
+  return true;
+}
+
+/*!
+    @brief  Mark the record invalid because the panel is about to change.
+    @return None (void).
+    @note   Called by the display before the first dot pulse after a save
+            or restore. Only the magic byte is written and nothing is
+            committed: real EEPROM takes the byte at once, while
+            flash-emulated EEPROM keeps it in RAM until the next save's
+            commit, so the refresh never waits for a sector erase and
+            flash wears once per save, not twice.
+*/
+void HANOVER_FLIPDOT_Persist::invalidate(void) {
+  if (begin())
+    write(addr, 0);
+}
+
+/*!
+    @brief  CRC of the display's current shadow.
+    @return CRC-16/CCITT of the state bytes.
+*/
+uint16_t HANOVER_FLIPDOT_Persist::checksum(void) {
+  return HANOVER_FLIPDOT_crc16(display->shadow,
+                               size() - HANOVER_FLIPDOT_PERSIST_HEADER);
+}
+
+/*!
+    @brief  Prepare the backend. Called before every access; only the
+            first call does anything.
+    @return true if the backend is usable, false otherwise.
+    @note   Without the EEPROM library there is nothing to set up, so a
+            subclass that only overrides read(), write() and commit() is
+            used as is. With no override at all read() returns 0xFF, no
+            record ever matches and begin() of the display sweeps.
+*/
+bool HANOVER_FLIPDOT_Persist::begin(void) {
+#if defined(HANOVER_FLIPDOT_HAS_EEPROM) &&                                     \
+    (defined(ESP32) || defined(ESP8266) || defined(ARDUINO_ARCH_RP2040))
+  if (!started)
+    EEPROM.begin(addr + size());
+#endif
+  started = true;
+  return true;
+}
+
+/*!
+    @brief  Read one byte of non-volatile memory.
+    @param  addr
+            Absolute address.
+    @return Byte stored there.
+*/
+uint8_t HANOVER_FLIPDOT_Persist::read(uint16_t addr) {
+#if defined(HANOVER_FLIPDOT_HAS_EEPROM)
+  return EEPROM.read(addr);
+#else
+  (void)addr;
+  return 0xFF;
+#endif
+}
+
+/*!
+    @brief  Write one byte of non-volatile memory, skipping the write if
+            the byte already holds the value.
+    @param  addr
+            Absolute address.
+    @param  value
+            Byte to store.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Persist::write(uint16_t addr, uint8_t value) {
+#if defined(HANOVER_FLIPDOT_HAS_EEPROM)
+  if (EEPROM.read(addr) != value)
+    EEPROM.write(addr, value);
+#else
+  (void)addr;
+  (void)value;
+#endif
+}
+
+/*!
+    @brief  Make previous writes durable.
+    @return None (void).
+    @note   Flash-emulated EEPROM only writes on commit; real EEPROM has
+            nothing to do.
+*/
+void HANOVER_FLIPDOT_Persist::commit(void) {
+#if defined(HANOVER_FLIPDOT_HAS_EEPROM) &&                                     \
+    (defined(ESP32) || defined(ESP8266) || defined(ARDUINO_ARCH_RP2040))
+  EEPROM.commit();
+#endif
+}
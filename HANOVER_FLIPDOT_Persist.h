@@ -0,0 +1,78 @@
+/*!
+ * @file HANOVER_FLIPDOT_Persist.h
+ *
+ * Keeps the last driven dot state of an Adafruit_HANOVER_FLIPDOT panel in
+ * non-volatile memory so begin() can skip the full wipe.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HANOVER_FLIPDOT_PERSIST_H_
+#define _HANOVER_FLIPDOT_PERSIST_H_
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+
+#if defined(ARDUINO) && defined(__has_include)
+#if __has_include(<EEPROM.h>)
+#include <EEPROM.h>
+#define HANOVER_FLIPDOT_HAS_EEPROM ///< Default backend is the EEPROM library
+#endif
+#endif
+
+#define HANOVER_FLIPDOT_PERSIST_HEADER 6 ///< Magic (2), width, height, CRC (2)
+
+/*!
+    @brief  Saves the panel's physical dot state, with a CRC, whenever it
+            changes (at most once per interval, to spare the memory), and
+            hands it back to begin() after a reset. If the saved state
+            checks out, begin() trusts it and the first display() is an
+            ordinary diff; otherwise begin() falls back to the full sweep.
+
+            The record is marked invalid before the first dot is pulsed
+            after a save. On real EEPROM (AVR) that mark is durable at
+            once, so a power cut mid-refresh can only ever cost a sweep,
+            never a wrong picture. On flash-emulated EEPROM the mark only
+            reaches flash with the next save (a commit per change would
+            erase a sector inside the refresh loop), so a power cut
+            before then restores the last saved state; call save() before
+            a planned power-down.
+
+            The default backend is the Arduino EEPROM library (emulated in
+            flash on ESP32, ESP8266 and RP2040). Override read(), write()
+            and commit() to use NVS, an external FRAM or anything else;
+            override begin() as well only if that backend needs setting
+            up before its first access.
+*/
+class HANOVER_FLIPDOT_Persist {
+public:
+  HANOVER_FLIPDOT_Persist(Adafruit_HANOVER_FLIPDOT *display, uint16_t addr = 0,
+                          uint32_t interval_ms = 60000);
+  virtual ~HANOVER_FLIPDOT_Persist(void);
+
+  uint16_t size(void);
+  bool update(void);
+  bool save(void);
+
+protected:
+  bool load(void);
+  void invalidate(void);
+  uint16_t checksum(void);
+  virtual bool begin(void);
+  virtual uint8_t read(uint16_t addr);
+  virtual void write(uint16_t addr, uint8_t value);
+  virtual void commit(void);
+
+  Adafruit_HANOVER_FLIPDOT *display; ///< Display whose state is kept
+  uint16_t addr;        ///< Offset of the record in non-volatile memory
+  uint32_t interval_ms; ///< Minimum time between two saves
+  uint32_t last_ms;     ///< millis() at the last save
+  bool started;         ///< begin() has run
+
+  friend class Adafruit_HANOVER_FLIPDOT;
+};
+
+#endif // _HANOVER_FLIPDOT_PERSIST_H_
@@ -0,0 +1,143 @@
+/*!
+ * @file HANOVER_FLIPDOT_RefreshTask.cpp
+ *
+ * Runs the Adafruit_HANOVER_FLIPDOT refresh engine on a core of its own,
+ * so coil dwell times never stall the application. The only state shared
+ * between the cores is the display's triple-buffer handoff byte, which is
+ * a single-producer/single-consumer channel of depth one: a frame that is
+ * overtaken before the panel gets to it is dropped rather than queued.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "HANOVER_FLIPDOT_RefreshTask.h"
+
+/*!
+    @brief  Constructor for a refresh task.
+    @param  display
+            Display to refresh. Its begin() must have been called (that is
+            the last time the application core touches the pins).
+    @return HANOVER_FLIPDOT_RefreshTask object.
+*/
+HANOVER_FLIPDOT_RefreshTask::HANOVER_FLIPDOT_RefreshTask(
+    Adafruit_HANOVER_FLIPDOT *display)
+    : display(display), running(0), shown(0) {
+#if defined(ESP32)
+  handle = NULL;
+#elif !defined(ARDUINO)
+  thread = NULL;
+#endif
+}
+
+/*!
+    @brief  Destructor, stops the task.
+*/
+HANOVER_FLIPDOT_RefreshTask::~HANOVER_FLIPDOT_RefreshTask(void) { end(); }
+
+/*!
+    @brief  Enable triple buffering on the display and start refreshing.
+    @param  core
+            ESP32 core to pin the task to (normally 1, leaving core 0 to
+            WiFi/BT, or the opposite of the Arduino loop core). Ignored
+            elsewhere.
+    @param  priority
+            FreeRTOS task priority on ESP32. Ignored elsewhere.
+    @return true on success, false if the frames could not be allocated or
+            the task could not be started.
+    @note   On RP2040 nothing is started: call poll() from loop1().
+*/
+bool HANOVER_FLIPDOT_RefreshTask::begin(uint8_t core, uint8_t priority) {
+  if (!display->enableTripleBuffering())
+    return false;
+  if (__atomic_exchange_n(&running, 1, __ATOMIC_ACQ_REL))
+    return true; // Already running
+#if defined(ESP32)
+  if (xTaskCreatePinnedToCore(run, "flipdot", HANOVER_FLIPDOT_TASK_STACK,
+                              this, priority, &handle, core) != pdPASS) {
+    __atomic_store_n(&running, 0, __ATOMIC_RELEASE);
+    return false;
+  }
+#elif !defined(ARDUINO)
+  (void)core;
+  (void)priority;
+  thread = new std::thread(run, this);
+#else
+  (void)core;
+  (void)priority;
+#endif
+  return true;
+}
+
+/*!
+    @brief  Stop refreshing. Frames committed afterwards are not shown
+            until begin() is called again.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_RefreshTask::end(void) {
+  if (!__atomic_exchange_n(&running, 0, __ATOMIC_ACQ_REL))
+    return;
+#if defined(ESP32)
+  // run() deletes its own task once it sees running == 0
+  while (__atomic_load_n(&handle, __ATOMIC_ACQUIRE))
+    vTaskDelay(1);
+#elif !defined(ARDUINO)
+  thread->join();
+  delete thread;
+  thread = NULL;
+#endif
+}
+
+/*!
+    @brief  Show the newest committed frame, if there is one, else spend
+            idle time on the display's stuck-dot exercise (if enabled).
+            The task calls this in a loop; call it yourself from loop1()
+            on RP2040.
+    @return true if a frame was shown.
+*/
+bool HANOVER_FLIPDOT_RefreshTask::poll(void) {
+  if (!display->displayLatest()) {
+    display->exercise();
+    return false;
+  }
+  __atomic_add_fetch(&shown, 1, __ATOMIC_RELAXED);
+  return true;
+}
+
+/*!
+    @brief  Count of frames shown since begin(). Frames that were
+            committed but overtaken before the panel got to them are not
+            counted.
+    @return Number of frames.
+*/
+uint32_t HANOVER_FLIPDOT_RefreshTask::framesShown(void) {
+  return __atomic_load_n(&shown, __ATOMIC_RELAXED);
+}
+
+/*!
+    @brief  Task body: poll until end() is called, yielding while there is
+            nothing new to show.
+    @param  arg
+            The HANOVER_FLIPDOT_RefreshTask.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_RefreshTask::run(void *arg) {
+  HANOVER_FLIPDOT_RefreshTask *t = (HANOVER_FLIPDOT_RefreshTask *)arg;
+  while (__atomic_load_n(&t->running, __ATOMIC_ACQUIRE)) {
+    if (!t->poll()) {
+#if defined(ESP32)
+      vTaskDelay(1);
+#elif !defined(ARDUINO)
+      std::this_thread::yield();
+#endif
+    }
+  }
+  t->poll(); // Don't lose a frame committed just before end()
+#if defined(ESP32)
+  __atomic_store_n(&t->handle, (TaskHandle_t)NULL, __ATOMIC_RELEASE);
+  vTaskDelete(NULL);
+#endif
+}
@@ -0,0 +1,64 @@
+/*!
+ * @file HANOVER_FLIPDOT_RefreshTask.h
+ *
+ * Runs the Adafruit_HANOVER_FLIPDOT refresh engine on a core of its own.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HANOVER_FLIPDOT_REFRESHTASK_H_
+#define _HANOVER_FLIPDOT_REFRESHTASK_H_
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#elif !defined(ARDUINO)
+#include <thread>
+#endif
+
+#ifndef HANOVER_FLIPDOT_TASK_STACK
+#define HANOVER_FLIPDOT_TASK_STACK 2048 ///< ESP32 refresh task stack, bytes
+#endif
+
+/*!
+    @brief  Moves all counter and coil work off the application core. The
+            application draws into the display's buffer and calls
+            commitFrame(); the refresh core picks up the newest committed
+            frame through the lock-free triple-buffer handoff and drives
+            the panel.
+
+            - ESP32: begin() starts a FreeRTOS task pinned to a core.
+            - RP2040: call poll() from loop1() on the second core.
+            - Host builds (no ARDUINO): begin() starts a std::thread, so
+              the same handoff and engine can be stress-tested on a PC.
+*/
+class HANOVER_FLIPDOT_RefreshTask {
+public:
+  HANOVER_FLIPDOT_RefreshTask(Adafruit_HANOVER_FLIPDOT *display);
+  ~HANOVER_FLIPDOT_RefreshTask(void);
+
+  bool begin(uint8_t core = 1, uint8_t priority = 1);
+  void end(void);
+  bool poll(void);
+  uint32_t framesShown(void);
+
+protected:
+  static void run(void *arg);
+
+  Adafruit_HANOVER_FLIPDOT *display; ///< Display refreshed by the task
+  uint8_t running;  ///< Non-zero while the task should keep going. Atomic.
+  uint32_t shown;   ///< Frames displayed so far. Atomic.
+#if defined(ESP32)
+  TaskHandle_t handle; ///< FreeRTOS task running run()
+#elif !defined(ARDUINO)
+  std::thread *thread; ///< Host thread running run()
+#endif
+};
+
+#endif // _HANOVER_FLIPDOT_REFRESHTASK_H_
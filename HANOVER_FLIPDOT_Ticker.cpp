@@ -0,0 +1,236 @@
+/*!
+ * @file HANOVER_FLIPDOT_Ticker.cpp
+ *
+ * Scrolling text band for Adafruit_HANOVER_FLIPDOT displays. The band is
+ * moved with whole-byte copies of the page-major display buffer and only
+ * the columns scrolled into view are rendered, one glyph cell at a time,
+ * so the per-step CPU cost depends on the band height rather than on the
+ * length of the message.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#elif defined(ESP8266) || defined(ESP32) || defined(ARDUINO_ARCH_RP2040)
+#include <pgmspace.h>
+#else
+#define pgm_read_byte(addr)                                                    \
+  (*(const unsigned char *)(addr)) ///< PROGMEM workaround for non-AVR
+#endif
+#ifndef pgm_read_pointer
+#if !defined(__INT_MAX__) || (__INT_MAX__ > 0xFFFF)
+#define pgm_read_pointer(addr)                                                 \
+  ((void *)(*(const unsigned long *)(addr))) ///< 32-bit ptr
+#else
+#define pgm_read_pointer(addr)                                                 \
+  ((void *)(*(const unsigned short *)(addr))) ///< 16-bit ptr
+#endif
+#endif
+
+#include "HANOVER_FLIPDOT_Ticker.h"
+
+/*!
+    @brief  Constructor for a ticker band.
+    @param  display
+            Display whose buffer the band lives in. The display's begin()
+            must have been called before the ticker is stepped.
+    @param  y
+            Top row of the band, in unrotated panel coordinates.
+    @param  h
+            Height of the band in rows.
+    @param  x
+            Left column of the band, in unrotated panel coordinates.
+    @param  w
+            Width of the band in columns, or 0 to run to the right edge.
+    @return HANOVER_FLIPDOT_Ticker object.
+    @note   Call begin() to choose the font before use. The band is cut
+            to the panel; one that starts off the panel is empty, and
+            step() does nothing.
+*/
+HANOVER_FLIPDOT_Ticker::HANOVER_FLIPDOT_Ticker(
+    Adafruit_HANOVER_FLIPDOT *display, uint8_t y, uint8_t h, uint8_t x,
+    uint8_t w)
+    : display(display), cell(NULL), text(""), next(""), x(x), y(y), w(w),
+      h(h), baseline(0), cell_col(0), cell_adv(0), gap(0) {
+  // A band starting off the panel is empty; one running off it is cut
+  if (x >= display->WIDTH)
+    this->w = 0;
+  else if ((this->w == 0) || (x + this->w > display->WIDTH))
+    this->w = display->WIDTH - x;
+  if (y >= display->HEIGHT)
+    this->h = 0;
+  else if (y + h > display->HEIGHT)
+    this->h = display->HEIGHT - y;
+}
+
+/*!
+    @brief  Destructor for HANOVER_FLIPDOT_Ticker object.
+*/
+HANOVER_FLIPDOT_Ticker::~HANOVER_FLIPDOT_Ticker(void) {
+  if (cell) {
+    delete cell;
+    cell = NULL;
+  }
+}
+
+/*!
+    @brief  Allocate the glyph cell for a font.
+    @param  font
+            GFX font to scroll in, or NULL for the built-in 6x8 font.
+    @param  size
+            Text magnification, as for setTextSize().
+    @param  baseline
+            y position within the band passed to drawChar(). 0 puts the
+            top of the built-in font at the top of the band; GFX fonts
+            draw above their baseline, so pass roughly the font's ascent.
+    @return true on successful allocation, false otherwise.
+*/
+bool HANOVER_FLIPDOT_Ticker::begin(const GFXfont *font, uint8_t size,
+                                   int8_t baseline) {
+  uint16_t cw = 6;
+  if (font) {
+    uint8_t first = pgm_read_byte(&font->first);
+    uint8_t last = pgm_read_byte(&font->last);
+    GFXglyph *glyph = (GFXglyph *)pgm_read_pointer(&font->glyph);
+    cw = 0;
+    for (uint16_t i = 0; i <= last - first; i++) {
+      uint8_t adv = pgm_read_byte(&glyph[i].xAdvance);
+      int16_t ink = (int8_t)pgm_read_byte(&glyph[i].xOffset) +
+                    pgm_read_byte(&glyph[i].width);
+      if (adv > cw)
+        cw = adv;
+      if (ink > (int16_t)cw)
+        cw = ink;
+    }
+  }
+  cw *= size ? size : 1;
+
+  if (cell)
+    delete cell;
+  cell = new GFXcanvas1(cw, h);
+  if (!cell || !cell->getBuffer())
+    return false;
+  cell->setFont(font);
+  cell->setTextSize(size);
+  cell->setTextWrap(false);
+  cell->setTextColor(HANOVER_FLIPDOT_YELLOW);
+  this->baseline = baseline;
+  setText(text);
+  return true;
+}
+
+/*!
+    @brief  Set the message to scroll. It enters from the right edge of the
+            band on the next step().
+    @param  str
+            Null-terminated string. Not copied, so it must stay valid (and
+            unchanged) while the ticker runs.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Ticker::setText(const char *str) {
+  text = next = str;
+  cell_col = cell_adv = 0;
+  gap = 0;
+}
+
+/*!
+    @brief  Scroll the band left.
+    @param  n
+            Number of columns to scroll.
+    @param  refresh
+            If true, push the band to the panel with displayRegion(). Pass
+            false to batch several bands into one display() call.
+    @return true if the end of the message (plus a band-width gap) went
+            past during this step and the message has started again.
+*/
+bool HANOVER_FLIPDOT_Ticker::step(uint8_t n, bool refresh) {
+  if (!cell || !w || !h)
+    return false;
+  if (n > w)
+    n = w;
+
+  shiftBand(n);
+  bool looped = false;
+  uint8_t *buf = display->buffer;
+  for (uint8_t col = x + w - n; col < x + w; col++) {
+    if (nextColumn() == 0)
+      looped = true;
+    for (uint8_t r = 0; r < h; r++) {
+      uint8_t row = y + r;
+      uint8_t *b = &buf[col + (row / 8) * display->WIDTH];
+      if (cell->getPixel(cell_col, r))
+        *b |= (1 << (row & 7));
+      else
+        *b &= ~(1 << (row & 7));
+    }
+    cell_col++;
+  }
+
+  if (refresh)
+    display->displayRegion(x, y, w, h);
+  return looped;
+}
+
+/*!
+    @brief  Make sure the cell holds the glyph for the next column to be
+            emitted, rendering the next character (or a blank gap) once the
+            current one is used up.
+    @return Number of characters of the message still to come once this
+            cell is done. 0 is returned once per pass, for the first column
+            after the message has started again.
+*/
+uint8_t HANOVER_FLIPDOT_Ticker::nextColumn(void) {
+  uint8_t remaining = 1;
+  while (cell_col >= cell_adv) {
+    cell->fillScreen(HANOVER_FLIPDOT_BLACK);
+    cell_col = 0;
+    if (*next) {
+      cell->setCursor(0, baseline);
+      cell->write(*next++);
+      cell_adv = cell->getCursorX(); // 0 for unprintable characters
+      if (!*next)
+        gap = w; // Let the end of the message scroll fully out
+    } else if (gap) {
+      cell_adv = gap;
+      gap = 0;
+    } else {
+      next = text;
+      remaining = 0;
+      cell_adv = *next ? 0 : w; // Empty message: emit blank columns
+    }
+  }
+  return remaining;
+}
+
+/*!
+    @brief  Move the band n columns left in the display buffer. Pages that
+            lie entirely inside the band are moved with memmove(); pages the
+            band only partly covers are merged under a row mask so rows
+            outside the band keep their contents.
+    @param  n
+            Number of columns to shift, at most the band width.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Ticker::shiftBand(uint8_t n) {
+  uint8_t count = w - n;
+  uint8_t last = y + h - 1;
+  for (uint8_t page = y / 8; page <= last / 8; page++) {
+    uint8_t mask = 0xFF;
+    if (page == y / 8)
+      mask &= 0xFF << (y & 7);
+    if (page == last / 8)
+      mask &= 0xFF >> (7 - (last & 7));
+    uint8_t *row = &display->buffer[page * display->WIDTH + x];
+    if (mask == 0xFF) {
+      memmove(row, row + n, count);
+    } else {
+      for (uint8_t i = 0; i < count; i++)
+        row[i] = (row[i] & ~mask) | (row[i + n] & mask);
+    }
+  }
+}
@@ -0,0 +1,54 @@
+/*!
+ * @file HANOVER_FLIPDOT_Ticker.h
+ *
+ * Scrolling text band for Adafruit_HANOVER_FLIPDOT displays.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HANOVER_FLIPDOT_TICKER_H_
+#define _HANOVER_FLIPDOT_TICKER_H_
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+
+/*!
+    @brief  A band of rows on a HANOVER_FLIPDOT display that scrolls a
+            string right to left. Each step shifts the band in place in the
+            display buffer, renders only the newly exposed columns and
+            refreshes only the band, so the panel pulses only the dots that
+            really changed.
+*/
+class HANOVER_FLIPDOT_Ticker {
+public:
+  HANOVER_FLIPDOT_Ticker(Adafruit_HANOVER_FLIPDOT *display, uint8_t y,
+                         uint8_t h, uint8_t x = 0, uint8_t w = 0);
+  ~HANOVER_FLIPDOT_Ticker(void);
+
+  bool begin(const GFXfont *font = NULL, uint8_t size = 1,
+             int8_t baseline = 0);
+  void setText(const char *str);
+  bool step(uint8_t n = 1, bool refresh = true);
+
+protected:
+  uint8_t nextColumn(void);
+  void shiftBand(uint8_t n);
+
+  Adafruit_HANOVER_FLIPDOT *display; ///< Display whose buffer is scrolled
+  GFXcanvas1 *cell;     ///< One glyph cell, rendered once per character
+  const char *text;     ///< Message being scrolled, not copied
+  const char *next;     ///< Next character of text to render
+  uint8_t x;            ///< Left column of the band, unrotated
+  uint8_t y;            ///< Top row of the band, unrotated
+  uint8_t w;            ///< Band width in columns
+  uint8_t h;            ///< Band height in rows
+  int8_t baseline;      ///< y passed to drawChar() within the cell
+  uint8_t cell_col;     ///< Column of the current cell to emit next
+  uint8_t cell_adv;     ///< Advance of the glyph in the current cell
+  uint8_t gap;          ///< Blank columns still to emit after the text
+};
+
+#endif // _HANOVER_FLIPDOT_TICKER_H_
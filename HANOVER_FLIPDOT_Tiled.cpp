@@ -0,0 +1,248 @@
+/*!
+ * @file HANOVER_FLIPDOT_Tiled.cpp
+ *
+ * One Adafruit_GFX drawing surface spread over several
+ * Adafruit_HANOVER_FLIPDOT panels. A pixel is routed to its panel by
+ * comparing against the panel edges (at most four compares, no divide)
+ * and written directly into that panel's page-major buffer.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "HANOVER_FLIPDOT_Tiled.h"
+
+/*!
+    @brief  Constructor for a tiled surface.
+    @param  panels
+            Array of panel objects, left to right (or top to bottom). Each
+            must have its own display_idx passed to begin().
+    @param  count
+            Number of panels, 1 to 4.
+    @param  vertical
+            false if the panels sit side by side, true if stacked.
+    @return HANOVER_FLIPDOT_Tiled object.
+    @note   Call begin() on every panel before drawing.
+*/
+HANOVER_FLIPDOT_Tiled::HANOVER_FLIPDOT_Tiled(Adafruit_HANOVER_FLIPDOT **panels,
+                                             uint8_t count, bool vertical)
+    : Adafruit_GFX(span(panels, count, vertical, true),
+                   span(panels, count, vertical, false)),
+      count(count > HANOVER_FLIPDOT_MAX_PANELS ? HANOVER_FLIPDOT_MAX_PANELS
+                                               : count),
+      vertical(vertical), dirty(0) {
+  int16_t edge = 0;
+  for (uint8_t i = 0; i < this->count; i++) {
+    this->panels[i] = panels[i];
+    edge += vertical ? panels[i]->HEIGHT : panels[i]->WIDTH;
+    end[i] = edge;
+  }
+}
+
+/*!
+    @brief  Size of the combined surface along one axis.
+    @param  panels
+            Array of panel objects.
+    @param  count
+            Number of panels.
+    @param  vertical
+            true if the panels are stacked.
+    @param  x_axis
+            true for the width, false for the height.
+    @return Sum of the panel sizes along the axis the panels are laid out
+            on, otherwise the size of the smallest panel.
+*/
+int16_t HANOVER_FLIPDOT_Tiled::span(Adafruit_HANOVER_FLIPDOT **panels,
+                                    uint8_t count, bool vertical,
+                                    bool x_axis) {
+  if (count > HANOVER_FLIPDOT_MAX_PANELS)
+    count = HANOVER_FLIPDOT_MAX_PANELS;
+  int16_t total = 0, least = count ? 0x7FFF : 0;
+  for (uint8_t i = 0; i < count; i++) {
+    int16_t size = x_axis ? panels[i]->WIDTH : panels[i]->HEIGHT;
+    total += size;
+    if (size < least)
+      least = size;
+  }
+  return (x_axis != vertical) ? total : least;
+}
+
+/*!
+    @brief  Find the buffer byte and bit holding an unrotated surface pixel.
+    @param  x
+            Column on the surface, in range.
+    @param  y
+            Row on the surface, in range.
+    @param  mask
+            Pointer to returned bit mask within the byte.
+    @param  panel
+            Pointer to returned index of the owning panel.
+    @param  write
+            true to get the byte to draw into, which is a copy-on-write
+            page copy while a requestDisplay() refresh is reading it.
+    @return Pointer into the owning panel's buffer (or page copy).
+*/
+uint8_t *HANOVER_FLIPDOT_Tiled::locate(int16_t x, int16_t y, uint8_t *mask,
+                                       uint8_t *panel, bool write) {
+  int16_t along = vertical ? y : x;
+  uint8_t i = 0;
+  while ((i < count - 1) && (along >= end[i]))
+    i++;
+  if (i) {
+    if (vertical)
+      y -= end[i - 1];
+    else
+      x -= end[i - 1];
+  }
+  *panel = i;
+  *mask = 1 << (y & 7);
+  Adafruit_HANOVER_FLIPDOT *p = panels[i];
+  if (write)
+    return p->writablePage(y >> 3) + x;
+  return (uint8_t *)p->readablePage(y >> 3) + x;
+}
+
+/*!
+    @brief  Set/clear/invert a single pixel on whichever panel it falls.
+    @param  x
+            Column of the surface -- 0 at left to (width - 1) at right.
+    @param  y
+            Row of the surface -- 0 at top to (height - 1) at bottom.
+    @param  color
+            Pixel color, one of: HANOVER_FLIPDOT_BLACK,
+            HANOVER_FLIPDOT_YELLOW or HANOVER_FLIPDOT_INVERSE.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Tiled::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+    return;
+  int16_t t;
+  switch (getRotation()) {
+  case 1:
+    t = x;
+    x = WIDTH - y - 1;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - x - 1;
+    y = HEIGHT - y - 1;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - t - 1;
+    break;
+  }
+  uint8_t mask, panel;
+  uint8_t *b = locate(x, y, &mask, &panel, true);
+  dirty |= 1 << panel;
+  switch (color) {
+  case HANOVER_FLIPDOT_YELLOW:
+    *b |= mask;
+    break;
+  case HANOVER_FLIPDOT_BLACK:
+    *b &= ~mask;
+    break;
+  case HANOVER_FLIPDOT_INVERSE:
+    *b ^= mask;
+    break;
+  }
+}
+
+/*!
+    @brief  Return color of a single pixel of the surface.
+    @param  x
+            Column of the surface.
+    @param  y
+            Row of the surface.
+    @return true if pixel is set, false if clear or out of bounds.
+*/
+bool HANOVER_FLIPDOT_Tiled::getPixel(int16_t x, int16_t y) {
+  if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+    return false;
+  int16_t t;
+  switch (getRotation()) {
+  case 1:
+    t = x;
+    x = WIDTH - y - 1;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - x - 1;
+    y = HEIGHT - y - 1;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - t - 1;
+    break;
+  }
+  uint8_t mask, panel;
+  return *locate(x, y, &mask, &panel, false) & mask;
+}
+
+/*!
+    @brief  Fill every panel with one color.
+    @param  color
+            HANOVER_FLIPDOT_BLACK or HANOVER_FLIPDOT_YELLOW.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Tiled::fillScreen(uint16_t color) {
+  for (uint8_t i = 0; i < count; i++) {
+    Adafruit_HANOVER_FLIPDOT *p = panels[i];
+    for (uint8_t page = 0; page < (p->HEIGHT + 7) / 8; page++)
+      memset(p->writablePage(page),
+             (color == HANOVER_FLIPDOT_YELLOW) ? 0xFF : 0x00, p->WIDTH);
+    p->clearPadding();
+  }
+  dirty = (1 << count) - 1;
+}
+
+/*!
+    @brief  Clear every panel's buffer.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Tiled::clearDisplay(void) {
+  fillScreen(HANOVER_FLIPDOT_BLACK);
+}
+
+/*!
+    @brief  Invert (or restore) every panel. See
+            Adafruit_HANOVER_FLIPDOT::invertDisplay().
+    @param  i
+            true for black-on-yellow, false for normal.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Tiled::invertDisplay(bool i) {
+  for (uint8_t p = 0; p < count; p++)
+    panels[p]->invertDisplay(i);
+  dirty = (1 << count) - 1;
+}
+
+/*!
+    @brief  Push the drawing to the panels. Panels nothing was drawn to
+            since the last call are skipped entirely.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Tiled::display(void) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (dirty & (1 << i))
+      panels[i]->display();
+  }
+  dirty = 0;
+}
+
+/*!
+    @brief  Get one of the panels, e.g. to use its bulk buffer operations.
+    @param  i
+            Panel index, 0 for the leftmost (or top) panel.
+    @return Panel object, or NULL if out of range.
+    @note   Drawing through the panel directly bypasses dirty tracking;
+            call that panel's display() yourself.
+*/
+Adafruit_HANOVER_FLIPDOT *HANOVER_FLIPDOT_Tiled::getPanel(uint8_t i) {
+  return (i < count) ? panels[i] : NULL;
+}
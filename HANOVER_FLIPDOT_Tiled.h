@@ -0,0 +1,53 @@
+/*!
+ * @file HANOVER_FLIPDOT_Tiled.h
+ *
+ * One Adafruit_GFX drawing surface spread over several
+ * Adafruit_HANOVER_FLIPDOT panels.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HANOVER_FLIPDOT_TILED_H_
+#define _HANOVER_FLIPDOT_TILED_H_
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+
+#define HANOVER_FLIPDOT_MAX_PANELS 4 ///< One per disp*_enable_pin
+
+/*!
+    @brief  Presents up to four panels, side by side or stacked, as a
+            single Adafruit_GFX surface with 16-bit coordinates. Drawing
+            goes straight into the buffer of the panel it lands on, and
+            display() refreshes only the panels that were drawn to.
+*/
+class HANOVER_FLIPDOT_Tiled : public Adafruit_GFX {
+public:
+  HANOVER_FLIPDOT_Tiled(Adafruit_HANOVER_FLIPDOT **panels, uint8_t count,
+                        bool vertical = false);
+
+  void display(void);
+  void clearDisplay(void);
+  void invertDisplay(bool i);
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void fillScreen(uint16_t color);
+  bool getPixel(int16_t x, int16_t y);
+  Adafruit_HANOVER_FLIPDOT *getPanel(uint8_t i);
+
+protected:
+  static int16_t span(Adafruit_HANOVER_FLIPDOT **panels, uint8_t count,
+                      bool vertical, bool x_axis);
+  uint8_t *locate(int16_t x, int16_t y, uint8_t *mask, uint8_t *panel,
+                  bool write);
+
+  Adafruit_HANOVER_FLIPDOT *panels[HANOVER_FLIPDOT_MAX_PANELS]; ///< Panels in order
+  int16_t end[HANOVER_FLIPDOT_MAX_PANELS]; ///< First x (or y) past each panel
+  uint8_t count;    ///< Number of panels
+  bool vertical;    ///< true if panels are stacked top to bottom
+  uint8_t dirty;    ///< Bit i set if panel i was drawn to since display()
+};
+
+#endif // _HANOVER_FLIPDOT_TILED_H_
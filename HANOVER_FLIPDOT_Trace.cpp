@@ -0,0 +1,287 @@
+/*!
+ * @file HANOVER_FLIPDOT_Trace.cpp
+ *
+ * VCD waveform recorder for the Adafruit_HANOVER_FLIPDOT control lines.
+ * The display hands every pin write and every wait to the trace; waits
+ * advance a simulated clock in microseconds, which is the VCD timescale.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#if !defined(ARDUINO)
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const names[HANOVER_FLIPDOT_TRACE_SIGNALS] = {
+    "reset", "row_adv", "col_adv", "set", "coil",
+    "en1",   "en2",     "en3",     "en4"}; ///< VCD signal names
+
+/*!
+    @brief  Constructor for a trace. Attaches itself to the display; other
+            panels driven over the same lines can be attached with their
+            setPinTrace().
+    @param  display
+            Display whose pin numbers name the signals.
+    @return HANOVER_FLIPDOT_VCDTrace object.
+*/
+HANOVER_FLIPDOT_VCDTrace::HANOVER_FLIPDOT_VCDTrace(
+    Adafruit_HANOVER_FLIPDOT *display)
+    : display(display), file(NULL), col(0), row(0) {
+  dots = (uint8_t *)calloc(display->WIDTH * ((display->HEIGHT + 7) / 8), 1);
+  pins[HANOVER_FLIPDOT_TRACE_RESET] = display->reset_pin;
+  pins[HANOVER_FLIPDOT_TRACE_ROW] = display->row_adv_pin;
+  pins[HANOVER_FLIPDOT_TRACE_COL] = display->col_adv_pin;
+  pins[HANOVER_FLIPDOT_TRACE_SET] = display->set_pin;
+  pins[HANOVER_FLIPDOT_TRACE_COIL] = display->coil_pulse_pin;
+  pins[HANOVER_FLIPDOT_TRACE_EN1] = display->disp1_enable_pin;
+  pins[HANOVER_FLIPDOT_TRACE_EN1 + 1] = display->disp2_enable_pin;
+  pins[HANOVER_FLIPDOT_TRACE_EN1 + 2] = display->disp3_enable_pin;
+  pins[HANOVER_FLIPDOT_TRACE_EN1 + 3] = display->disp4_enable_pin;
+  memset(level, 2, sizeof(level)); // Unknown until first driven
+  reset();
+  display->setPinTrace(this);
+}
+
+/*!
+    @brief  Destructor, closes the file and detaches from the display.
+*/
+HANOVER_FLIPDOT_VCDTrace::~HANOVER_FLIPDOT_VCDTrace(void) {
+  end();
+  if (display->trace == this)
+    display->setPinTrace(NULL);
+  free(dots);
+}
+
+/*!
+    @brief  Start writing a VCD file. Counting runs with or without one.
+    @param  path
+            File to create, or NULL to only count.
+    @return true on success, false if the file could not be created.
+*/
+bool HANOVER_FLIPDOT_VCDTrace::begin(const char *path) {
+  end();
+  if (!path)
+    return true;
+  if (!(file = fopen(path, "w")))
+    return false;
+  fprintf(file, "$timescale 1us $end\n$scope module flipdot $end\n");
+  for (uint8_t i = 0; i < HANOVER_FLIPDOT_TRACE_SIGNALS; i++)
+    if (pins[i] >= 0)
+      fprintf(file, "$var wire 1 %c %s $end\n", 'A' + i, names[i]);
+  fprintf(file, "$upscope $end\n$enddefinitions $end\n#%llu\n$dumpvars\n",
+          (unsigned long long)counts.us);
+  for (uint8_t i = 0; i < HANOVER_FLIPDOT_TRACE_SIGNALS; i++)
+    if (pins[i] >= 0)
+      fprintf(file, "%c%c\n", "01x"[level[i]], 'A' + i);
+  fprintf(file, "$end\n");
+  stamped = counts.us;
+  return true;
+}
+
+/*!
+    @brief  Finish and close the VCD file, if any.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_VCDTrace::end(void) {
+  if (!file)
+    return;
+  fprintf(file, "#%llu\n", (unsigned long long)counts.us);
+  fclose(file);
+  file = NULL;
+}
+
+/*!
+    @brief  Zero the edge counters and clock.
+    @return None (void).
+    @note   Line levels, the simulated counters and the dot matrix are
+            kept, like a real panel's, so a scene can be measured on its
+            own.
+*/
+void HANOVER_FLIPDOT_VCDTrace::reset(void) {
+  memset(&counts, 0, sizeof(counts));
+  stamped = 0;
+}
+
+/*!
+    @brief  Get the summary counters.
+    @return Edge counts per signal and simulated time so far. Rising edges
+            of ROW/COL are counter advances, falling edges of RESET are
+            counter resets, rising edges of COIL are dot pulses.
+*/
+const HANOVER_FLIPDOT_TraceStats &HANOVER_FLIPDOT_VCDTrace::stats(void) {
+  return counts;
+}
+
+/*!
+    @brief  Record a pin write.
+    @param  pin
+            Pin written.
+    @param  value
+            HIGH or LOW.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_VCDTrace::pin(int8_t pin, uint8_t value) {
+  value = value ? 1 : 0;
+  for (uint8_t i = 0; i < HANOVER_FLIPDOT_TRACE_SIGNALS; i++) {
+    if ((pins[i] != pin) || (level[i] == value))
+      continue;
+    if (value)
+      counts.rising[i]++; // Outputs start low, so from unknown too
+    else if (level[i] == 1)
+      counts.falling[i]++;
+    if (value && (level[i] != 1))
+      rise(i);
+    else if (!value && (i == HANOVER_FLIPDOT_TRACE_RESET))
+      col = row = 0; // Active low
+    level[i] = value;
+    if (file) {
+      if (counts.us != stamped) {
+        fprintf(file, "#%llu\n", (unsigned long long)counts.us);
+        stamped = counts.us;
+      }
+      fprintf(file, "%c%c\n", '0' + value, 'A' + i);
+    }
+  }
+}
+
+/*!
+    @brief  Decode a rising edge the way the panel would.
+    @param  signal
+            Signal index.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_VCDTrace::rise(uint8_t signal) {
+  uint8_t steps = HANOVER_FLIPDOT_COUNTER_STEPS;
+  if (signal == HANOVER_FLIPDOT_TRACE_COL)
+    col = (col + 1) & (steps - 1);
+  else if (signal == HANOVER_FLIPDOT_TRACE_ROW)
+    row = (row + 1) & (steps - 1);
+  if ((signal != HANOVER_FLIPDOT_TRACE_COIL) || !dots ||
+      (col >= display->WIDTH) || (row >= display->HEIGHT))
+    return;
+  uint8_t en = HANOVER_FLIPDOT_TRACE_EN1 + display->panel_idx - 1;
+  if ((en < HANOVER_FLIPDOT_TRACE_SIGNALS) && (pins[en] >= 0) &&
+      (level[en] != 1))
+    return; // Panel not selected
+  uint8_t *b = &dots[col + (row / 8) * display->WIDTH];
+  if (level[HANOVER_FLIPDOT_TRACE_SET] == 1)
+    *b |= 1 << (row & 7);
+  else
+    *b &= ~(1 << (row & 7));
+}
+
+/*!
+    @brief  Check a scene against its recorded budget.
+    @param  max_pulses
+            Most coil pulses allowed since reset().
+    @param  max_us
+            Most simulated microseconds allowed since reset().
+    @return true if both are within budget.
+*/
+bool HANOVER_FLIPDOT_VCDTrace::withinBudget(uint32_t max_pulses,
+                                            uint64_t max_us) {
+  return (counts.rising[HANOVER_FLIPDOT_TRACE_COIL] <= max_pulses) &&
+         (counts.us <= max_us);
+}
+
+/*!
+    @brief  Get a dot of the simulated panel.
+    @param  x
+            Column, unrotated.
+    @param  y
+            Row, unrotated.
+    @return true if the coil pulses decoded so far leave it yellow.
+*/
+bool HANOVER_FLIPDOT_VCDTrace::getDot(uint8_t x, uint8_t y) {
+  if (!dots || (x >= display->WIDTH) || (y >= display->HEIGHT))
+    return false;
+  return dots[x + (y / 8) * display->WIDTH] & (1 << (y & 7));
+}
+
+/*!
+    @brief  Save the simulated panel as a plain (P1) PBM image, one text
+            row per dot row, 1 for a yellow dot.
+    @param  path
+            File to create.
+    @return true on success, false otherwise.
+*/
+bool HANOVER_FLIPDOT_VCDTrace::writePBM(const char *path) {
+  FILE *f = fopen(path, "w");
+  if (!f)
+    return false;
+  fprintf(f, "P1\n%d %d\n", display->WIDTH, display->HEIGHT);
+  for (uint8_t y = 0; y < display->HEIGHT; y++) {
+    for (uint8_t x = 0; x < display->WIDTH; x++)
+      fputc(getDot(x, y) ? '1' : '0', f);
+    fputc('\n', f);
+  }
+  return fclose(f) == 0;
+}
+
+/*!
+    @brief  Compare the simulated panel against a golden PBM image.
+    @param  path
+            Plain (P1) or raw (P4) PBM of the panel's size.
+    @return Number of dots that differ (0 for a match), or -1 if the file
+            cannot be read or is not a PBM of the panel's size.
+*/
+int32_t HANOVER_FLIPDOT_VCDTrace::comparePBM(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return -1;
+  int w = 0, h = 0, c;
+  char magic[3] = {0};
+  bool ok = (fscanf(f, "%2s", magic) == 1) &&
+            (!strcmp(magic, "P1") || !strcmp(magic, "P4"));
+  while (ok && ((c = fgetc(f)) != EOF)) { // Skip whitespace and comments
+    if (c == '#')
+      while (((c = fgetc(f)) != EOF) && (c != '\n'))
+        ;
+    else if (!isspace(c)) {
+      ungetc(c, f);
+      break;
+    }
+  }
+  ok = ok && (fscanf(f, "%d %d", &w, &h) == 2) && (w == display->WIDTH) &&
+       (h == display->HEIGHT);
+  if (ok && (magic[1] == '4'))
+    fgetc(f); // Single whitespace before raw data
+  int32_t diff = 0;
+  for (int y = 0; ok && (y < h); y++) {
+    int byte = 0;
+    for (int x = 0; ok && (x < w); x++) {
+      bool set;
+      if (magic[1] == '4') {
+        if (!(x & 7))
+          ok = ((byte = fgetc(f)) != EOF);
+        set = byte & (0x80 >> (x & 7));
+      } else {
+        while (((c = fgetc(f)) != EOF) && isspace(c))
+          ;
+        ok = (c == '0') || (c == '1');
+        set = (c == '1');
+      }
+      if (ok && (set != getDot(x, y)))
+        diff++;
+    }
+  }
+  fclose(f);
+  return ok ? diff : -1;
+}
+
+/*!
+    @brief  Advance the simulated clock.
+    @param  us
+            Microseconds the driver waits.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_VCDTrace::wait(uint32_t us) { counts.us += us; }
+
+#endif // !ARDUINO
@@ -0,0 +1,92 @@
+/*!
+ * @file HANOVER_FLIPDOT_Trace.h
+ *
+ * Host-side recorder of the counter and coil pin sequence an
+ * Adafruit_HANOVER_FLIPDOT drives, written as a VCD waveform.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HANOVER_FLIPDOT_TRACE_H_
+#define _HANOVER_FLIPDOT_TRACE_H_
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+
+#if !defined(ARDUINO)
+#include <stdio.h>
+
+#define HANOVER_FLIPDOT_TRACE_RESET 0   ///< Signal index of reset_pin
+#define HANOVER_FLIPDOT_TRACE_ROW 1     ///< Signal index of row_adv_pin
+#define HANOVER_FLIPDOT_TRACE_COL 2     ///< Signal index of col_adv_pin
+#define HANOVER_FLIPDOT_TRACE_SET 3     ///< Signal index of set_pin
+#define HANOVER_FLIPDOT_TRACE_COIL 4    ///< Signal index of coil_pulse_pin
+#define HANOVER_FLIPDOT_TRACE_EN1 5     ///< Signal index of disp1_enable_pin
+#define HANOVER_FLIPDOT_TRACE_SIGNALS 9 ///< Signals traced (EN1 to EN4 last)
+
+/*!
+    @brief  Summary of a trace, for benchmarks and budget checks.
+*/
+typedef struct {
+  uint32_t rising[HANOVER_FLIPDOT_TRACE_SIGNALS]; ///< Rising edges per signal
+  uint32_t falling[HANOVER_FLIPDOT_TRACE_SIGNALS]; ///< Falling edges per signal
+  uint64_t us; ///< Simulated time, the sum of all driver waits
+} HANOVER_FLIPDOT_TraceStats;
+
+/*!
+    @brief  Records every transition on reset_pin, row_adv_pin,
+            col_adv_pin, set_pin, coil_pulse_pin and the four enable pins,
+            timestamped with simulated time (the sum of the driver's own
+            waits, so the trace shows the timing the driver intends, not
+            how fast the host runs). Writes a VCD file for GTKWave and
+            keeps edge counters either way.
+
+            The trace also decodes the lines the way the panel would
+            (CD4024 counters, coil pulses gated by the display's enable
+            line) into a simulated dot matrix. Comparing that against a
+            golden PBM image checks what the driver actually drove, not
+            what it meant to; together with the counters this is enough
+            for a golden-frame regression harness with pulse and time
+            budgets.
+
+            Host builds only (no ARDUINO); on hardware, use a logic
+            analyser.
+*/
+class HANOVER_FLIPDOT_VCDTrace {
+public:
+  HANOVER_FLIPDOT_VCDTrace(Adafruit_HANOVER_FLIPDOT *display);
+  ~HANOVER_FLIPDOT_VCDTrace(void);
+
+  bool begin(const char *path = NULL);
+  void end(void);
+  void reset(void);
+  const HANOVER_FLIPDOT_TraceStats &stats(void);
+  bool withinBudget(uint32_t max_pulses, uint64_t max_us);
+  bool getDot(uint8_t x, uint8_t y);
+  bool writePBM(const char *path);
+  int32_t comparePBM(const char *path);
+
+protected:
+  void pin(int8_t pin, uint8_t value);
+  void wait(uint32_t us);
+  void rise(uint8_t signal);
+
+  Adafruit_HANOVER_FLIPDOT *display; ///< First display traced
+  FILE *file;       ///< VCD output, or NULL to count only
+  int8_t pins[HANOVER_FLIPDOT_TRACE_SIGNALS];   ///< Pin of each signal
+  uint8_t level[HANOVER_FLIPDOT_TRACE_SIGNALS]; ///< Last level, 2 unknown
+  uint64_t stamped; ///< Time of the last timestamp written
+  uint8_t col;      ///< Simulated column counter
+  uint8_t row;      ///< Simulated row counter
+  uint8_t *dots;    ///< Simulated dot matrix, getBuffer() layout
+  HANOVER_FLIPDOT_TraceStats counts; ///< Edge counters and clock
+
+  friend class Adafruit_HANOVER_FLIPDOT;
+};
+
+#endif // !ARDUINO
+
+#endif // _HANOVER_FLIPDOT_TRACE_H_
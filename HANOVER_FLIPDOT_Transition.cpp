@@ -0,0 +1,160 @@
+/*!
+ * @file HANOVER_FLIPDOT_Transition.cpp
+ *
+ * Frame-to-frame transition effects for Adafruit_HANOVER_FLIPDOT displays.
+ * Rather than drawing intermediate frames, which would pulse dots that end
+ * up unchanged (or pulse a dot several times), each effect is only an
+ * order in which the differing dots are driven to their final state.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "HANOVER_FLIPDOT_Transition.h"
+
+/*!
+    @brief  Constructor for a transition.
+    @param  display
+            Display to transition. Its begin() must have been called.
+    @return HANOVER_FLIPDOT_Transition object.
+*/
+HANOVER_FLIPDOT_Transition::HANOVER_FLIPDOT_Transition(
+    Adafruit_HANOVER_FLIPDOT *display)
+    : display(display), effect(HANOVER_FLIPDOT_WIPE), cell(4), step_ms(0),
+      steps(0), pos(0), lcg(0), lcg_mask(0), last_ms(0) {}
+
+/*!
+    @brief  Start a transition from what the panel shows now to the display
+            buffer.
+    @param  effect
+            HANOVER_FLIPDOT_WIPE, HANOVER_FLIPDOT_WIPE_DOWN,
+            HANOVER_FLIPDOT_SLIDE, HANOVER_FLIPDOT_DISSOLVE or
+            HANOVER_FLIPDOT_CHECKERBOARD.
+    @param  step_ms
+            Minimum time between steps, used by update() and run(). A step
+            is one column (one row for HANOVER_FLIPDOT_WIPE_DOWN, one
+            column's worth of random dots for HANOVER_FLIPDOT_DISSOLVE).
+    @param  target
+            If not NULL, a frame in getBuffer() layout copied into the
+            display buffer first. Otherwise whatever has been drawn into
+            the buffer is the target.
+    @param  cell
+            Square size in dots for HANOVER_FLIPDOT_CHECKERBOARD.
+    @return None (void).
+    @note   HANOVER_FLIPDOT_SLIDE shows the leading edge of a frame moving
+            in from the right. Sliding the whole image would pulse dots
+            more than once, so the content appears in place behind the
+            edge.
+*/
+void HANOVER_FLIPDOT_Transition::begin(uint8_t effect, uint16_t step_ms,
+                                       const uint8_t *target, uint8_t cell) {
+  uint8_t w = display->WIDTH, h = display->HEIGHT;
+  if (target)
+    memcpy(display->buffer, target, w * ((h + 7) / 8));
+  this->effect = effect;
+  this->step_ms = step_ms;
+  this->cell = cell ? cell : 1;
+  pos = 0;
+  last_ms = millis() - step_ms;
+  switch (effect) {
+  case HANOVER_FLIPDOT_WIPE_DOWN:
+    steps = h;
+    break;
+  case HANOVER_FLIPDOT_CHECKERBOARD:
+    steps = 2 * w;
+    break;
+  case HANOVER_FLIPDOT_DISSOLVE:
+    steps = w;
+    lcg_mask = 1;
+    while (lcg_mask < (uint16_t)(w * h - 1))
+      lcg_mask = (lcg_mask << 1) | 1;
+    lcg = 0;
+    break;
+  default:
+    steps = w;
+    break;
+  }
+}
+
+/*!
+    @brief  Run the next step of the transition now.
+    @return true if there are more steps to run, false once the panel
+            matches the buffer.
+*/
+bool HANOVER_FLIPDOT_Transition::step(void) {
+  if (pos >= steps)
+    return false;
+  Adafruit_HANOVER_FLIPDOT *d = display;
+  uint8_t w = d->WIDTH, h = d->HEIGHT;
+
+  switch (effect) {
+  case HANOVER_FLIPDOT_WIPE_DOWN:
+    for (uint8_t x = 0; x < w; x++)
+      d->refreshDot(x, pos);
+    break;
+  case HANOVER_FLIPDOT_SLIDE:
+    for (uint8_t y = 0; y < h; y++)
+      d->refreshDot(w - 1 - pos, y);
+    break;
+  case HANOVER_FLIPDOT_CHECKERBOARD: {
+    uint8_t x = pos % w, phase = pos / w;
+    for (uint8_t y = 0; y < h; y++)
+      if ((((x / cell) + (y / cell)) & 1) == phase)
+        d->refreshDot(x, y);
+    break;
+  }
+  case HANOVER_FLIPDOT_DISSOLVE: {
+    // Full-period LCG over a power of two covering every dot: each index
+    // comes up exactly once per pass, those past the end are skipped.
+    uint16_t n = (uint16_t)w * h;
+    for (uint8_t i = 0; i < h;) {
+      if (lcg < n) {
+        d->refreshDot(lcg % w, lcg / w);
+        i++;
+      }
+      lcg = (lcg * 25173U + 13849U) & lcg_mask;
+      if (!lcg) // Back at the start: every dot has been visited
+        break;
+    }
+    break;
+  }
+  default: // HANOVER_FLIPDOT_WIPE
+    for (uint8_t y = 0; y < h; y++)
+      d->refreshDot(pos, y);
+    break;
+  }
+  return ++pos < steps;
+}
+
+/*!
+    @brief  Run the next step if step_ms has passed since the last one. Call
+            from loop() to run a transition without blocking.
+    @return true while the transition is in progress.
+*/
+bool HANOVER_FLIPDOT_Transition::update(void) {
+  if (done())
+    return false;
+  if ((uint32_t)(millis() - last_ms) >= step_ms) {
+    last_ms = millis();
+    step();
+  }
+  return !done();
+}
+
+/*!
+    @brief  Run the whole transition, waiting step_ms between steps.
+    @return None (void).
+*/
+void HANOVER_FLIPDOT_Transition::run(void) {
+  while (update())
+    ;
+}
+
+/*!
+    @brief  Check whether the transition has finished.
+    @return true once every step has run.
+*/
+bool HANOVER_FLIPDOT_Transition::done(void) const { return pos >= steps; }
@@ -0,0 +1,53 @@
+/*!
+ * @file HANOVER_FLIPDOT_Transition.h
+ *
+ * Frame-to-frame transition effects for Adafruit_HANOVER_FLIPDOT displays.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HANOVER_FLIPDOT_TRANSITION_H_
+#define _HANOVER_FLIPDOT_TRANSITION_H_
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+
+#define HANOVER_FLIPDOT_WIPE 0         ///< Column by column, left to right
+#define HANOVER_FLIPDOT_WIPE_DOWN 1    ///< Row by row, top to bottom
+#define HANOVER_FLIPDOT_SLIDE 2        ///< Leading edge enters from the right
+#define HANOVER_FLIPDOT_DISSOLVE 3     ///< Pseudo-random dot order
+#define HANOVER_FLIPDOT_CHECKERBOARD 4 ///< Alternate squares, then the rest
+
+/*!
+    @brief  Moves the panel from what it shows now to the display buffer in
+            a chosen visual order. Only dots that differ are pulsed, each
+            exactly once, so a transition costs the same number of coil
+            pulses as a plain display().
+*/
+class HANOVER_FLIPDOT_Transition {
+public:
+  HANOVER_FLIPDOT_Transition(Adafruit_HANOVER_FLIPDOT *display);
+
+  void begin(uint8_t effect, uint16_t step_ms = 20,
+             const uint8_t *target = NULL, uint8_t cell = 4);
+  bool step(void);
+  bool update(void);
+  void run(void);
+  bool done(void) const;
+
+protected:
+  Adafruit_HANOVER_FLIPDOT *display; ///< Display being transitioned
+  uint8_t effect;    ///< One of the HANOVER_FLIPDOT_WIPE etc. effects
+  uint8_t cell;      ///< Square size for HANOVER_FLIPDOT_CHECKERBOARD
+  uint16_t step_ms;  ///< Time between steps
+  uint16_t steps;    ///< Total number of steps for this effect
+  uint16_t pos;      ///< Next step to run
+  uint16_t lcg;      ///< Dissolve generator state
+  uint16_t lcg_mask; ///< Dissolve generator modulus - 1 (power of two)
+  uint32_t last_ms;  ///< millis() when the last step ran
+};
+
+#endif // _HANOVER_FLIPDOT_TRANSITION_H_
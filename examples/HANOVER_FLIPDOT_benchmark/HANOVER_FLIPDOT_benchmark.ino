@@ -0,0 +1,230 @@
+/**************************************************************************
+ Drawing benchmark for Adafruit_HANOVER_FLIPDOT
+
+ Measures the CPU cost of the Adafruit_GFX primitives on the flipdot
+ frame buffer -- drawPixel, lines, rectangles, circles, drawBitmap, text
+ and getPixel -- in all four rotations, and runs the same set on an
+ Adafruit_SSD1306 buffer of the same size as a baseline. Refresh time is
+ not included: that is dominated by the coils, see estimateRefresh().
+
+ For every primitive and rotation it prints the flipdot's ops/s, ns per
+ pixel touched, CPU cycles per op where F_CPU is known (on AVR this is
+ the real cycle count) and an AVR cycle estimate from a simple cost
+ model (see AVR_CYCLES_PER_PIXEL below), so host and ARM runs can be
+ read against an 8-bit target; then the SSD1306's ops/s and ns per pixel
+ for the same operation. Run it on the controller you care about; on a
+ host it builds as the benchmark target of tests/CMakeLists.txt, with
+ stub Wire and SPI, and times with the host clock.
+
+ No panel needs to be connected: begin(false) skips the counter reset,
+ and since begin() drives no dots, it only configures the control pins
+ and raises EN1. Keep those pins free. The SSD1306 baseline does need a
+ display at I2C address 0x3C for its begin(); set COMPARE_SSD1306 to 0
+ to skip it.
+
+ Written by Andrew Littlejohn (Caustic) for LMNC, with
+ contributions from the open source community.
+ BSD license, check license.txt for more information
+ All text above must be included in any redistribution.
+ **************************************************************************/
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_HANOVER_FLIPDOT.h>
+
+// Set to 0 if Adafruit_SSD1306 (and Wire) is not available on the target
+#ifndef COMPARE_SSD1306
+#define COMPARE_SSD1306 1
+#endif
+
+#if COMPARE_SSD1306
+#define NO_ADAFRUIT_SSD1306_COLOR_COMPATIBILITY // BLACK etc. are the flipdot's
+#include <Adafruit_SSD1306.h>
+#endif
+
+#define PANEL_WIDTH  96 // Dots across
+#define PANEL_HEIGHT 16 // Dots down
+
+// Control lines of the panel (counters, coil, enables)
+#define RESET_PIN  2
+#define ROW_PIN    3
+#define COL_PIN    4
+#define COIL_PIN   5
+#define SET_PIN    6
+#define EN1_PIN    7
+
+#ifndef BENCH_MS
+#define BENCH_MS 200 // Time spent on each primitive and rotation
+#endif
+
+// Simple AVR cost model: every flipdot pixel goes through drawPixel()
+// (virtual call, bounds and rotation checks, page address, a variable
+// shift that AVR does one bit per cycle pair, read-modify-write) plus the
+// primitive's own per-pixel loop; each call adds a fixed setup cost.
+// Ballpark figures for an ATmega at any clock -- on AVR, compare them
+// with the measured cycles column and adjust.
+#define AVR_CYCLES_PER_PIXEL 100
+#define AVR_CYCLES_PER_CALL  200
+
+#if defined(ARDUINO)
+#define benchMicros() micros()
+#else
+// Host: the Arduino shims' micros() is simulated time, use the real clock
+#include <chrono>
+static uint32_t benchMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+#endif
+
+Adafruit_HANOVER_FLIPDOT flipdot(PANEL_WIDTH, PANEL_HEIGHT, RESET_PIN,
+                                 ROW_PIN, COL_PIN, COIL_PIN, SET_PIN,
+                                 EN1_PIN, -1, -1, -1);
+#if COMPARE_SSD1306
+Adafruit_SSD1306 oled(PANEL_WIDTH, PANEL_HEIGHT);
+#endif
+
+static const unsigned char PROGMEM logo_bmp[] =
+{ 0b00000000, 0b11000000,
+  0b00000001, 0b11000000,
+  0b00000001, 0b11000000,
+  0b00000011, 0b11100000,
+  0b11110011, 0b11100000,
+  0b11111110, 0b11111000,
+  0b01111110, 0b11111111,
+  0b00110011, 0b10011111,
+  0b00011111, 0b11111100,
+  0b00001101, 0b01110000,
+  0b00011011, 0b10100000,
+  0b00111111, 0b11100000,
+  0b00111111, 0b11110000,
+  0b01111100, 0b11110000,
+  0b01110000, 0b01110000,
+  0b00000000, 0b00110000 };
+
+enum { PIXEL, HLINE, VLINE, LINE, RECT, FILLRECT, CIRCLE, FILLCIRCLE,
+       BITMAP, TEXT, GETPIXEL, PRIMITIVES };
+
+static const char *const names[PRIMITIVES] = {
+  "drawPixel", "drawFastHLine", "drawFastVLine", "drawLine", "drawRect",
+  "fillRect", "drawCircle", "fillCircle", "drawBitmap", "print", "getPixel" };
+
+volatile uint8_t sink; // Keeps getPixel() results alive
+
+// One operation of a primitive; returns the pixels it touches
+template <class D> uint16_t op(D &d, uint8_t prim, uint16_t i) {
+  int16_t w = d.width(), h = d.height();
+  int16_t x = i % w, y = (i / w) % h, r = ((w < h) ? w : h) / 2 - 1;
+  switch (prim) {
+  case PIXEL:
+    d.drawPixel(x, y, i & 1);
+    return 1;
+  case HLINE:
+    d.drawFastHLine(0, y, w, i & 1);
+    return w;
+  case VLINE:
+    d.drawFastVLine(x, 0, h, i & 1);
+    return h;
+  case LINE:
+    d.drawLine(0, 0, w - 1, y, i & 1);
+    return w;
+  case RECT:
+    d.drawRect(0, 0, w, h, i & 1);
+    return 2 * (w + h) - 4;
+  case FILLRECT:
+    d.fillRect(0, 0, w, h, i & 1);
+    return w * h;
+  case CIRCLE:
+    d.drawCircle(w / 2, h / 2, r, i & 1);
+    return 6 * r; // About 2 * pi * r
+  case FILLCIRCLE:
+    d.fillCircle(w / 2, h / 2, r, i & 1);
+    return 3 * r * r; // About pi * r^2
+  case BITMAP:
+    d.drawBitmap(x, 0, logo_bmp, 16, 16, i & 1);
+    return 16 * 16;
+  case TEXT:
+    d.setCursor(0, 0);
+    d.setTextColor(i & 1);
+    d.print(F("Flip"));
+    return 4 * 6 * 8;
+  default: // GETPIXEL
+    sink += d.getPixel(x, y);
+    return 1;
+  }
+}
+
+// Time spent, operations run and pixels touched by one primitive
+struct Result {
+  uint32_t us, ops, pixels;
+};
+
+// Runs one primitive in one rotation for BENCH_MS
+template <class D> Result measure(D &d, uint8_t prim, uint8_t rot) {
+  Result r = {0, 0, 0};
+  d.setRotation(rot);
+  uint32_t start = benchMicros();
+  do {
+    for (uint8_t k = 0; k < 16; k++, r.ops++)
+      r.pixels += op(d, prim, r.ops);
+  } while ((r.us = benchMicros() - start) < BENCH_MS * 1000UL);
+  if (!r.us)
+    r.us = 1;
+  d.setRotation(0);
+  return r;
+}
+
+// Runs every primitive in every rotation on the flipdot and the baseline
+void bench() {
+  Serial.println(F("\n                        Adafruit_HANOVER_FLIPDOT"
+                   "           Adafruit_SSD1306"));
+  Serial.println(F("primitive      rot     ops/s  ns/pixel  cycles/op  AVR est."
+                   "     ops/s  ns/pixel"));
+  for (uint8_t prim = 0; prim < PRIMITIVES; prim++) {
+    for (uint8_t rot = 0; rot < 4; rot++) {
+      Result f = measure(flipdot, prim, rot);
+      char line[100], cycles[12] = "-", est[12], oled_ops[12] = "-",
+                                  oled_ns[12] = "-";
+#ifdef F_CPU
+      snprintf(cycles, sizeof(cycles), "%lu",
+               (unsigned long)((double)f.us * (F_CPU / 1000000UL) / f.ops));
+#endif
+      snprintf(est, sizeof(est), "%lu",
+               (unsigned long)(AVR_CYCLES_PER_CALL + (double)f.pixels / f.ops *
+                                                         AVR_CYCLES_PER_PIXEL));
+#if COMPARE_SSD1306
+      Result o = measure(oled, prim, rot);
+      snprintf(oled_ops, sizeof(oled_ops), "%lu",
+               (unsigned long)(o.ops * 1000000.0 / o.us));
+      snprintf(oled_ns, sizeof(oled_ns), "%lu",
+               (unsigned long)(o.us * 1000.0 / o.pixels));
+#endif
+      snprintf(line, sizeof(line), "%-14s %3u %9lu %9lu %10s %9s %9s %9s",
+               names[prim], rot, (unsigned long)(f.ops * 1000000.0 / f.us),
+               (unsigned long)(f.us * 1000.0 / f.pixels), cycles, est,
+               oled_ops, oled_ns);
+      Serial.println(line);
+    }
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  // No counter reset; begin() marks the dots unknown rather than driving them
+  if (!flipdot.begin(false)) {
+    Serial.println(F("HANOVER_FLIPDOT allocation failed"));
+    for (;;); // Don't proceed, loop forever
+  }
+
+#if COMPARE_SSD1306
+  if (!oled.begin(SSD1306_SWITCHCAPVCC, 0x3C, true, true)) {
+    Serial.println(F("SSD1306 allocation failed"));
+    for (;;); // Don't proceed, loop forever
+  }
+#endif
+  bench();
+}
+
+void loop() {
+}
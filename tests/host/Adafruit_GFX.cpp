@@ -0,0 +1,415 @@
+/*!
+ * @file Adafruit_GFX.cpp
+ *
+ * Host stand-in for the Adafruit_GFX primitives. Lines, rectangles,
+ * circles and bitmaps follow the real library's algorithms so they set
+ * the same pixels.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_GFX.h"
+
+static void swap16(int16_t &a, int16_t &b) {
+  int16_t t = a;
+  a = b;
+  b = t;
+}
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h) {
+  _width = WIDTH;
+  _height = HEIGHT;
+  rotation = 0;
+  cursor_y = cursor_x = 0;
+  textsize_x = textsize_y = 1;
+  textcolor = textbgcolor = 0xFFFF;
+  wrap = true;
+  _cp437 = false;
+  gfxFont = NULL;
+}
+
+void Adafruit_GFX::writePixel(int16_t x, int16_t y, uint16_t color) {
+  drawPixel(x, y, color);
+}
+
+void Adafruit_GFX::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 uint16_t color) {
+  fillRect(x, y, w, h, color);
+}
+
+void Adafruit_GFX::writeFastVLine(int16_t x, int16_t y, int16_t h,
+                                  uint16_t color) {
+  drawFastVLine(x, y, h, color);
+}
+
+void Adafruit_GFX::writeFastHLine(int16_t x, int16_t y, int16_t w,
+                                  uint16_t color) {
+  drawFastHLine(x, y, w, color);
+}
+
+void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                             uint16_t color) {
+  int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    swap16(x0, y0);
+    swap16(x1, y1);
+  }
+  if (x0 > x1) {
+    swap16(x0, x1);
+    swap16(y0, y1);
+  }
+  int16_t dx = x1 - x0, dy = abs(y1 - y0), err = dx / 2;
+  int16_t ystep = (y0 < y1) ? 1 : -1;
+  for (; x0 <= x1; x0++) {
+    if (steep)
+      writePixel(y0, x0, color);
+    else
+      writePixel(x0, y0, color);
+    err -= dy;
+    if (err < 0) {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void Adafruit_GFX::setRotation(uint8_t x) {
+  rotation = (x & 3);
+  if (rotation & 1) {
+    _width = HEIGHT;
+    _height = WIDTH;
+  } else {
+    _width = WIDTH;
+    _height = HEIGHT;
+  }
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                 uint16_t color) {
+  writeLine(x, y, x, y + h - 1, color);
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                 uint16_t color) {
+  writeLine(x, y, x + w - 1, y, color);
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t color) {
+  for (int16_t i = x; i < x + w; i++)
+    writeFastVLine(i, y, h, color);
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+  fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                            uint16_t color) {
+  if (x0 == x1) {
+    if (y0 > y1)
+      swap16(y0, y1);
+    drawFastVLine(x0, y0, y1 - y0 + 1, color);
+  } else if (y0 == y1) {
+    if (x0 > x1)
+      swap16(x0, x1);
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+  } else {
+    writeLine(x0, y0, x1, y1, color);
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t color) {
+  writeFastHLine(x, y, w, color);
+  writeFastHLine(x, y + h - 1, w, color);
+  writeFastVLine(x, y, h, color);
+  writeFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r,
+                              uint16_t color) {
+  int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+  writePixel(x0, y0 + r, color);
+  writePixel(x0, y0 - r, color);
+  writePixel(x0 + r, y0, color);
+  writePixel(x0 - r, y0, color);
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    writePixel(x0 + x, y0 + y, color);
+    writePixel(x0 - x, y0 + y, color);
+    writePixel(x0 + x, y0 - y, color);
+    writePixel(x0 - x, y0 - y, color);
+    writePixel(x0 + y, y0 + x, color);
+    writePixel(x0 - y, y0 + x, color);
+    writePixel(x0 + y, y0 - x, color);
+    writePixel(x0 - y, y0 - x, color);
+  }
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r,
+                              uint16_t color) {
+  writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+  int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r, px = x,
+          py = y;
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (x < (y + 1)) {
+      writeFastVLine(x0 + x, y0 - y, 2 * y + 1, color);
+      writeFastVLine(x0 - x, y0 - y, 2 * y + 1, color);
+    }
+    if (y != py) {
+      writeFastVLine(x0 + py, y0 - px, 2 * px + 1, color);
+      writeFastVLine(x0 - py, y0 - px, 2 * px + 1, color);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                              int16_t w, int16_t h, uint16_t color) {
+  int16_t byteWidth = (w + 7) / 8;
+  uint8_t b = 0;
+  for (int16_t j = 0; j < h; j++, y++) {
+    for (int16_t i = 0; i < w; i++) {
+      if (i & 7)
+        b <<= 1;
+      else
+        b = bitmap[j * byteWidth + i / 8];
+      if (b & 0x80)
+        writePixel(x + i, y, color);
+    }
+  }
+}
+
+/*!
+    @brief  Column of the stand-in built-in font: distinct per character,
+            never blank, so text draws something but not real glyphs.
+*/
+static uint8_t glyphColumn(unsigned char c, uint8_t i) {
+  return (uint8_t)((c * 37 + i * 11) | 0x41);
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
+                            uint16_t color, uint16_t bg, uint8_t size_x,
+                            uint8_t size_y) {
+  if (!gfxFont) {
+    for (int8_t i = 0; i < 5; i++) {
+      uint8_t line = glyphColumn(c, i);
+      for (int8_t j = 0; j < 8; j++, line >>= 1) {
+        if (line & 1)
+          writeFillRect(x + i * size_x, y + j * size_y, size_x, size_y,
+                        color);
+        else if (bg != color)
+          writeFillRect(x + i * size_x, y + j * size_y, size_x, size_y, bg);
+      }
+    }
+    if (bg != color)
+      writeFillRect(x + 5 * size_x, y, size_x, 8 * size_y, bg);
+    return;
+  }
+  c -= gfxFont->first;
+  GFXglyph *glyph = &gfxFont->glyph[c];
+  const uint8_t *bitmap = gfxFont->bitmap;
+  uint16_t bo = glyph->bitmapOffset;
+  uint8_t w = glyph->width, h = glyph->height, bits = 0, bit = 0;
+  int8_t xo = glyph->xOffset, yo = glyph->yOffset;
+  for (uint8_t yy = 0; yy < h; yy++) {
+    for (uint8_t xx = 0; xx < w; xx++) {
+      if (!(bit++ & 7))
+        bits = bitmap[bo++];
+      if (bits & 0x80)
+        writeFillRect(x + (xo + xx) * size_x, y + (yo + yy) * size_y, size_x,
+                      size_y, color);
+      bits <<= 1;
+    }
+  }
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+  if (!gfxFont) {
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    } else if (c != '\r') {
+      if (wrap && ((cursor_x + textsize_x * 6) > _width)) {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+               textsize_y);
+      cursor_x += textsize_x * 6;
+    }
+    return 1;
+  }
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += (int16_t)textsize_y * gfxFont->yAdvance;
+  } else if ((c != '\r') && (c >= gfxFont->first) && (c <= gfxFont->last)) {
+    GFXglyph *glyph = &gfxFont->glyph[c - gfxFont->first];
+    if (glyph->width && glyph->height) {
+      int16_t xo = glyph->xOffset;
+      if (wrap && ((cursor_x + textsize_x * (xo + glyph->width)) > _width)) {
+        cursor_x = 0;
+        cursor_y += (int16_t)textsize_y * gfxFont->yAdvance;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+               textsize_y);
+    }
+    cursor_x += glyph->xAdvance * (int16_t)textsize_x;
+  }
+  return 1;
+}
+
+void Adafruit_GFX::charBounds(unsigned char c, int16_t *x, int16_t *y,
+                              int16_t *minx, int16_t *miny, int16_t *maxx,
+                              int16_t *maxy) {
+  if (!gfxFont) {
+    if (c == '\n') {
+      *x = 0;
+      *y += textsize_y * 8;
+    } else if (c != '\r') {
+      if (wrap && ((*x + textsize_x * 6) > _width)) {
+        *x = 0;
+        *y += textsize_y * 8;
+      }
+      int16_t x2 = *x + textsize_x * 6 - 1, y2 = *y + textsize_y * 8 - 1;
+      if (x2 > *maxx)
+        *maxx = x2;
+      if (y2 > *maxy)
+        *maxy = y2;
+      if (*x < *minx)
+        *minx = *x;
+      if (*y < *miny)
+        *miny = *y;
+      *x += textsize_x * 6;
+    }
+    return;
+  }
+  if (c == '\n') {
+    *x = 0;
+    *y += textsize_y * gfxFont->yAdvance;
+  } else if ((c != '\r') && (c >= gfxFont->first) && (c <= gfxFont->last)) {
+    GFXglyph *glyph = &gfxFont->glyph[c - gfxFont->first];
+    uint8_t gw = glyph->width, gh = glyph->height, xa = glyph->xAdvance;
+    int8_t xo = glyph->xOffset, yo = glyph->yOffset;
+    if (wrap && ((*x + (((int16_t)xo + gw) * textsize_x)) > _width)) {
+      *x = 0;
+      *y += textsize_y * gfxFont->yAdvance;
+    }
+    int16_t x1 = *x + xo * textsize_x, y1 = *y + yo * textsize_y,
+            x2 = x1 + gw * textsize_x - 1, y2 = y1 + gh * textsize_y - 1;
+    if (x1 < *minx)
+      *minx = x1;
+    if (y1 < *miny)
+      *miny = y1;
+    if (x2 > *maxx)
+      *maxx = x2;
+    if (y2 > *maxy)
+      *maxy = y2;
+    *x += xa * textsize_x;
+  }
+}
+
+void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y,
+                                 int16_t *x1, int16_t *y1, uint16_t *w,
+                                 uint16_t *h) {
+  uint8_t c;
+  int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -1, maxy = -1;
+  *x1 = x;
+  *y1 = y;
+  *w = *h = 0;
+  while ((c = *str++))
+    charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+  if (maxx >= minx) {
+    *x1 = minx;
+    *w = maxx - minx + 1;
+  }
+  if (maxy >= miny) {
+    *y1 = miny;
+    *h = maxy - miny + 1;
+  }
+}
+
+GFXcanvas1::GFXcanvas1(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
+  buffer = (uint8_t *)calloc(((w + 7) / 8) * h, 1);
+}
+
+GFXcanvas1::~GFXcanvas1(void) { free(buffer); }
+
+void GFXcanvas1::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+    return;
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - 1 - y;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - 1 - x;
+    y = HEIGHT - 1 - y;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - 1 - t;
+    break;
+  }
+  uint8_t *ptr = &buffer[(x / 8) + y * ((WIDTH + 7) / 8)];
+  if (color)
+    *ptr |= 0x80 >> (x & 7);
+  else
+    *ptr &= ~(0x80 >> (x & 7));
+}
+
+void GFXcanvas1::fillScreen(uint16_t color) {
+  memset(buffer, color ? 0xFF : 0x00, ((WIDTH + 7) / 8) * HEIGHT);
+}
+
+bool GFXcanvas1::getPixel(int16_t x, int16_t y) const {
+  if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+    return false;
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - 1 - y;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - 1 - x;
+    y = HEIGHT - 1 - y;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - 1 - t;
+    break;
+  }
+  return getRawPixel(x, y);
+}
+
+bool GFXcanvas1::getRawPixel(int16_t x, int16_t y) const {
+  return buffer[(x / 8) + y * ((WIDTH + 7) / 8)] & (0x80 >> (x & 7));
+}
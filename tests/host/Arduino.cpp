@@ -0,0 +1,61 @@
+/*!
+ * @file Arduino.cpp
+ *
+ * Simulated clock and pin stubs behind the host Arduino.h.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Arduino.h"
+#include <thread>
+
+static uint64_t now_us; ///< Simulated time. Atomic: tests refresh on threads.
+static uint8_t pins[256]; ///< Last value written to each pin
+
+HardwareSerial Serial;
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  __atomic_store_n(&pins[pin], value, __ATOMIC_RELAXED);
+}
+
+int digitalRead(uint8_t pin) {
+  return __atomic_load_n(&pins[pin], __ATOMIC_RELAXED);
+}
+
+static uint64_t timer_us;       ///< When timer_isr fires
+static void (*timer_isr)(void); ///< One-shot simulated interrupt, or NULL
+
+void hostAdvance(uint64_t us) {
+  uint64_t now = __atomic_add_fetch(&now_us, us, __ATOMIC_RELAXED);
+  if (timer_isr && (now >= timer_us)) {
+    void (*isr)(void) = timer_isr;
+    timer_isr = NULL; // One shot; the handler may arm the next
+    isr();
+  }
+}
+
+// Single-threaded tests only: the timer is not shared between threads.
+void hostTimer(uint64_t at_us, void (*isr)(void)) {
+  timer_us = at_us;
+  timer_isr = isr;
+}
+
+void delay(unsigned long ms) { hostAdvance((uint64_t)ms * 1000); }
+
+void delayMicroseconds(unsigned int us) { hostAdvance(us); }
+
+unsigned long micros(void) {
+  return (unsigned long)__atomic_load_n(&now_us, __ATOMIC_RELAXED);
+}
+
+unsigned long millis(void) {
+  return (unsigned long)(__atomic_load_n(&now_us, __ATOMIC_RELAXED) / 1000);
+}
+
+void yield(void) { std::this_thread::yield(); }
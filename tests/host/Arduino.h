@@ -0,0 +1,92 @@
+/*!
+ * @file Arduino.h
+ *
+ * Minimal Arduino core for building the library and its tests on a Linux
+ * host. Pins go nowhere (attach a HANOVER_FLIPDOT_VCDTrace to see them)
+ * and time is simulated: it only moves when the code under test waits,
+ * or when a test calls hostAdvance(). hostTimer() stands in for a timer
+ * interrupt, firing from inside whichever wait reaches its time.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROGMEM
+#define memcpy_P memcpy
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define F(s) (s)
+
+typedef bool boolean;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long micros(void);
+unsigned long millis(void);
+void yield(void);
+void hostAdvance(uint64_t us);
+void hostTimer(uint64_t at_us, void (*isr)(void));
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n) {
+    size_t r = 0;
+    while (n--)
+      r += write(*buf++);
+    return r;
+  }
+  size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned long v) {
+    char b[24];
+    snprintf(b, sizeof(b), "%lu", v);
+    return print(b);
+  }
+  size_t print(double v, int digits = 2) {
+    char b[32];
+    snprintf(b, sizeof(b), "%.*f", digits, v);
+    return print(b);
+  }
+  size_t println(void) { return print("\r\n"); }
+  size_t println(const char *s) { return print(s) + println(); }
+  size_t println(unsigned long v) { return print(v) + println(); }
+  size_t println(double v, int digits = 2) {
+    return print(v, digits) + println();
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available(void) = 0;
+  virtual int read(void) = 0;
+  virtual int peek(void) = 0;
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+  using Print::write;
+};
+
+extern HardwareSerial Serial; ///< Writes to stdout
+
+#endif // _HOST_ARDUINO_H_
@@ -0,0 +1,15 @@
+/*!
+ * @file SPI.cpp
+ *
+ * The global instance behind the host SPI.h.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "SPI.h"
+
+SPIClass SPI;
@@ -0,0 +1,29 @@
+/*!
+ * @file SPI.h
+ *
+ * Minimal SPI stand-in so Adafruit_SSD1306 builds on a Linux host.
+ * Transfers go nowhere and read back 0.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HOST_SPI_H_
+#define _HOST_SPI_H_
+
+#include "Arduino.h"
+
+class SPIClass {
+public:
+  void begin(void) {}
+  uint8_t transfer(uint8_t c) {
+    (void)c;
+    return 0;
+  }
+};
+
+extern SPIClass SPI; ///< Discards everything
+#endif // _HOST_SPI_H_
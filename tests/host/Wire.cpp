@@ -0,0 +1,15 @@
+/*!
+ * @file Wire.cpp
+ *
+ * The global instance behind the host Wire.h.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Wire.h"
+
+TwoWire Wire;
@@ -0,0 +1,34 @@
+/*!
+ * @file Wire.h
+ *
+ * Minimal I2C stand-in so Adafruit_SSD1306 builds on a Linux host (the
+ * benchmark uses it as a drawing baseline). Every transfer succeeds and
+ * goes nowhere.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#ifndef _HOST_WIRE_H_
+#define _HOST_WIRE_H_
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+  void begin(void) {}
+  void setClock(uint32_t hz) { (void)hz; }
+  void beginTransmission(uint8_t addr) { (void)addr; }
+  uint8_t endTransmission(void) { return 0; }
+  size_t write(uint8_t c) {
+    (void)c;
+    return 1;
+  }
+  size_t send(uint8_t c) { return write(c); } // Pre-1.0 name
+};
+
+extern TwoWire Wire; ///< Discards everything
+#endif // _HOST_WIRE_H_
@@ -0,0 +1,28 @@
+/*!
+ * @file benchmark.cpp
+ *
+ * Host entry point for examples/HANOVER_FLIPDOT_benchmark: builds the
+ * sketch against the host Arduino shims and runs setup() once. An
+ * optional argument sets the milliseconds spent per primitive and
+ * rotation (default 200).
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include <stdint.h>
+
+static uint32_t bench_ms = 200; ///< Time per primitive and rotation
+#define BENCH_MS bench_ms
+
+#include "../../examples/HANOVER_FLIPDOT_benchmark/HANOVER_FLIPDOT_benchmark.ino"
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+    bench_ms = atoi(argv[1]);
+  setup();
+  return 0;
+}
@@ -0,0 +1,12 @@
+/*!
+ * @file splash.h
+ *
+ * Empty stand-in for the splash screens scripts/Makefile generates for
+ * Adafruit_SSD1306; the host build defines SSD1306_NO_SPLASH.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
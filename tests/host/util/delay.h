@@ -0,0 +1,12 @@
+/*!
+ * @file delay.h
+ *
+ * Empty stand-in for avr-libc's util/delay.h, which Adafruit_SSD1306
+ * includes on every target that is not ARM or ESP.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
@@ -0,0 +1,116 @@
+/*!
+ * @file test_begin.cpp
+ *
+ * What begin() costs: by default it drives nothing and leaves every dot
+ * unknown, so the first refresh pulses each dot exactly once; wipe keeps
+ * the old yellow-then-black sweep. Checked for buffered and streaming
+ * mode.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#define W 96 ///< Panel width
+#define H 16 ///< Panel height
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Streaming renderer: a bar at column state.
+    @param  page
+            Page to render.
+    @param  state
+            Column of the bar.
+    @param  out
+            WIDTH bytes of page to fill.
+    @param  ctx
+            Unused.
+    @return None (void).
+*/
+static void bar(uint8_t page, uint32_t state, uint8_t *out, void *ctx) {
+  (void)page;
+  (void)ctx;
+  memset(out, 0, W);
+  out[state % W] = 0xFF;
+}
+
+/*!
+    @brief  Coil pulses since the trace was last reset, then reset it.
+    @param  trace
+            Trace to read.
+    @return Pulse count.
+*/
+static uint32_t pulses(HANOVER_FLIPDOT_VCDTrace &trace) {
+  uint32_t n = trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL];
+  trace.reset();
+  return n;
+}
+
+int main(void) {
+  {
+    Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+    HANOVER_FLIPDOT_VCDTrace trace(&d);
+    check(d.begin(), "begin");
+    check(pulses(trace) == 0, "begin drives nothing");
+    check(d.anyUnknown(), "begin leaves every dot unknown");
+    d.fillRect(0, 0, 8, 8, HANOVER_FLIPDOT_YELLOW);
+    d.display();
+    check(pulses(trace) == W * H, "first display drives each dot once");
+    check(!d.anyUnknown() && trace.getDot(7, 7) && !trace.getDot(8, 8),
+          "first display shows the buffer");
+    d.display();
+    check(pulses(trace) == 0, "second display is a plain diff");
+  }
+  {
+    Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+    HANOVER_FLIPDOT_VCDTrace trace(&d);
+    check(d.begin(true, 1, true), "begin with wipe");
+    check(pulses(trace) == 2 * W * H, "wipe sweeps yellow then black");
+    check(!d.anyUnknown(), "wipe leaves nothing unknown");
+    d.display();
+    check(pulses(trace) == 0, "blank display after wipe drives nothing");
+  }
+  {
+    Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+    HANOVER_FLIPDOT_VCDTrace trace(&d);
+    d.setRenderer(bar);
+    check(d.begin(), "streaming begin");
+    check(pulses(trace) == 0, "streaming begin drives nothing");
+    d.displayState(5);
+    check(pulses(trace) == W * H, "first state drives each dot once");
+    check(trace.getDot(5, 0) && !trace.getDot(6, 0), "first state shown");
+    d.displayState(6);
+    check(pulses(trace) == 2 * H, "next state is a plain diff");
+  }
+  {
+    Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+    HANOVER_FLIPDOT_VCDTrace trace(&d);
+    d.setRenderer(bar);
+    check(d.begin(true, 1, true), "streaming begin with wipe");
+    check(pulses(trace) == 2 * W * H, "streaming wipe sweeps");
+    d.displayState(5);
+    check(pulses(trace) == H, "state after wipe is a plain diff");
+  }
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+/*!
+ * @file test_bus.cpp
+ *
+ * HANOVER_FLIPDOT_Bus fed controller frames: a frame that fails its
+ * checksum, or is cut short, leaves nothing in the buffer for a refresh
+ * to show (with or without triple buffering), and with triple buffering
+ * frames narrower than the panel keep the rest of the last picture.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Bus.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+#include <string>
+
+#define W 96                    ///< Panel width
+#define H 16                    ///< Panel height
+#define PAGES ((H + 7) / 8)     ///< Bytes per column
+#define SIZE (W * PAGES)        ///< Buffer bytes
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Append a byte as two ASCII hex digits.
+    @param  s
+            String to append to.
+    @param  b
+            Byte.
+    @return None (void).
+*/
+static void hex(std::string &s, uint8_t b) {
+  static const char digits[] = "0123456789ABCDEF";
+  s += digits[b >> 4];
+  s += digits[b & 15];
+}
+
+/*!
+    @brief  Build a controller frame from the first columns of a picture.
+    @param  pic
+            Picture in getBuffer() layout.
+    @param  cols
+            Columns to send, from the left.
+    @return The frame, checksum included.
+*/
+static std::string frame(const uint8_t *pic, uint8_t cols) {
+  std::string s(1, (char)HANOVER_FLIPDOT_BUS_STX);
+  hex(s, 0x11);
+  hex(s, (uint8_t)(cols * PAGES));
+  for (uint8_t x = 0; x < cols; x++)
+    for (uint8_t p = 0; p < PAGES; p++)
+      hex(s, pic[p * W + x]);
+  s += (char)HANOVER_FLIPDOT_BUS_ETX;
+  uint8_t sum = 0;
+  for (size_t i = 1; i < s.size(); i++)
+    sum += s[i];
+  hex(s, -sum);
+  return s;
+}
+
+/*!
+    @brief  Feed a string to the parser.
+    @param  bus
+            Parser.
+    @param  s
+            Characters.
+    @return Number of frames shown.
+*/
+static uint16_t feed(HANOVER_FLIPDOT_Bus &bus, const std::string &s) {
+  uint16_t n = 0;
+  for (size_t i = 0; i < s.size(); i++)
+    n += bus.feed(s[i]);
+  return n;
+}
+
+/*!
+    @brief  Compare the decoded panel with a picture.
+    @param  trace
+            Trace decoding the panel.
+    @param  pic
+            Picture in getBuffer() layout.
+    @return true if every dot matches.
+*/
+static bool panelShows(HANOVER_FLIPDOT_VCDTrace &trace, const uint8_t *pic) {
+  for (uint8_t y = 0; y < H; y++)
+    for (uint8_t x = 0; x < W; x++)
+      if (trace.getDot(x, y) != !!(pic[x + (y / 8) * W] & (1 << (y & 7))))
+        return false;
+  return true;
+}
+
+/*!
+    @brief  Without triple buffering, rejected frames are put back before
+            a display() can show them.
+    @return None (void).
+*/
+static void testRejectedNotShown(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  HANOVER_FLIPDOT_Bus bus(&d, NULL);
+  check(d.begin(), "setup");
+
+  uint8_t pic[SIZE], other[SIZE];
+  for (uint16_t i = 0; i < SIZE; i++) {
+    pic[i] = i * 37;
+    other[i] = ~pic[i];
+  }
+  check(feed(bus, frame(pic, W)) == 1, "frame shown");
+  check(panelShows(trace, pic), "panel shows the frame");
+
+  std::string bad = frame(other, 40);
+  bad[bad.size() - 1] ^= 0x01; // Still a hex digit, wrong checksum
+  check(!feed(bus, bad) && (bus.framesRejected() == 1), "bad checksum");
+  check(!memcmp(d.getBuffer(), pic, SIZE), "buffer put back");
+
+  std::string cut = frame(other, 40).substr(0, 50);
+  cut += (char)HANOVER_FLIPDOT_BUS_STX; // The next frame starts
+  check(!feed(bus, cut) && (bus.framesRejected() == 2), "frame cut short");
+  check(!memcmp(d.getBuffer(), pic, SIZE), "buffer put back again");
+
+  trace.reset();
+  d.display();
+  check(trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL] == 0,
+        "display() after rejections drives nothing");
+}
+
+/*!
+    @brief  With triple buffering, frames of varying width each leave the
+            rest of the last picture in place, and a rejected frame leaves
+            nothing behind for the next, narrower one to commit.
+    @return None (void).
+*/
+static void testTripleBuffered(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  HANOVER_FLIPDOT_Bus bus(&d, NULL);
+  check(d.begin() && d.enableTripleBuffering(), "setup");
+
+  uint8_t pic[SIZE], next[SIZE];
+  memset(pic, 0, SIZE);
+  bool ok = true;
+  for (uint8_t n = 0; n < 20; n++) {
+    uint8_t cols = 10 + (n * 29) % (W - 10);
+    memcpy(next, pic, SIZE);
+    for (uint8_t x = 0; x < cols; x++)
+      for (uint8_t p = 0; p < PAGES; p++)
+        next[p * W + x] = (x + p) * (n + 3);
+    ok &= feed(bus, frame(next, cols)) == 1;
+    memcpy(pic, next, SIZE);
+    ok &= !memcmp(d.getBuffer(), pic, SIZE);
+    if (n % 3) // Let some commits pile up unseen
+      d.displayLatest();
+  }
+  check(ok, "narrow frames keep the rest of the picture");
+  d.displayLatest();
+  check(panelShows(trace, pic), "panel shows the last picture");
+
+  memset(next, 0xAA, SIZE);
+  std::string bad = frame(next, W);
+  bad[bad.size() - 1] ^= 0x01;
+  check(!feed(bus, bad), "bad checksum");
+  for (uint8_t p = 0; p < PAGES; p++)
+    pic[p * W] ^= 0xFF;
+  check(feed(bus, frame(pic, 1)) == 1, "narrow frame after a bad one");
+  d.displayLatest();
+  check(panelShows(trace, pic), "bad frame never shown");
+}
+
+int main(void) {
+  testRejectedNotShown();
+  testTripleBuffered();
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+/*!
+ * @file test_checkpoint.cpp
+ *
+ * Counter reset checkpoints: estimateRefresh() must predict exactly the
+ * resets, advances and pulses the refresh then drives, for a range of
+ * checkpoint intervals, and intervals too short to reach a dot between
+ * two resets must be raised instead of resetting before every dot.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#define W 96 ///< Panel width
+#define H 16 ///< Panel height
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Refresh a full-screen fill at one checkpoint interval.
+    @param  interval
+            Checkpoint interval to set.
+    @return Counter resets the refresh drove, or -1 if the estimate did
+            not match what was driven.
+*/
+static int32_t fillResets(uint16_t interval) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  d.begin();
+  d.display();
+  d.setCheckpointInterval(interval);
+  d.fillScreen(HANOVER_FLIPDOT_YELLOW);
+  HANOVER_FLIPDOT_RefreshCost cost;
+  d.estimateRefresh(&cost);
+  trace.reset();
+  d.display();
+  const HANOVER_FLIPDOT_TraceStats &st = trace.stats();
+  uint32_t resets = st.falling[HANOVER_FLIPDOT_TRACE_RESET];
+  uint32_t advances = st.rising[HANOVER_FLIPDOT_TRACE_ROW] +
+                      st.rising[HANOVER_FLIPDOT_TRACE_COL];
+  if ((cost.dots != st.rising[HANOVER_FLIPDOT_TRACE_COIL]) ||
+      (cost.resets != resets) || (cost.advances != advances)) {
+    printf("interval %u: estimated %lu dots %lu resets %lu advances, "
+           "drove %lu %lu %lu\n",
+           interval, (unsigned long)cost.dots, (unsigned long)cost.resets,
+           (unsigned long)cost.advances,
+           (unsigned long)st.rising[HANOVER_FLIPDOT_TRACE_COIL],
+           (unsigned long)resets, (unsigned long)advances);
+    return -1;
+  }
+  return resets;
+}
+
+int main(void) {
+  static const uint16_t intervals[] = {0, 1, 20, W + H, 200, 1000};
+  for (uint8_t i = 0; i < sizeof(intervals) / sizeof(intervals[0]); i++)
+    if (fillResets(intervals[i]) < 0)
+      errors++;
+
+  // Too short an interval behaves like the shortest useful one, about a
+  // reset per row rather than per dot
+  int32_t tiny = fillResets(1);
+  if ((tiny != fillResets(W + H)) || (tiny > 2 * H)) {
+    printf("interval 1: %ld resets\n", (long)tiny);
+    errors++;
+  }
+  return errors ? 1 : 0;
+}
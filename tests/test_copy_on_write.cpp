@@ -0,0 +1,168 @@
+/*!
+ * @file test_copy_on_write.cpp
+ *
+ * Copy-on-write drawing during a requestDisplay() refresh: a refresh
+ * shows the frame as it was requested, drawing done meanwhile (through
+ * drawPixel(), the bulk operations or a tiled surface) is neither torn
+ * into it nor lost afterwards, and a threaded stress run never shows a
+ * torn frame.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Tiled.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+#include <thread>
+
+#define W 96        ///< Panel width
+#define H 16        ///< Panel height
+#define FRAMES 300  ///< Frames in the stress run
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Compare the decoded panel with the display's buffer.
+    @param  trace
+            Trace decoding the panel.
+    @param  d
+            Display.
+    @return true if every dot matches getPixel().
+*/
+static bool panelShowsBuffer(HANOVER_FLIPDOT_VCDTrace &trace,
+                             Adafruit_HANOVER_FLIPDOT &d) {
+  for (uint8_t y = 0; y < H; y++)
+    for (uint8_t x = 0; x < W; x++)
+      if (trace.getDot(x, y) != d.getPixel(x, y))
+        return false;
+  return true;
+}
+
+/*!
+    @brief  Draws made while a pass is pending stay out of it, and are
+            still there (to read, draw over and display) once it is done.
+    @return None (void).
+*/
+static void testNoLostWrites(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  check(d.begin() && d.enableCopyOnWrite(2), "setup");
+
+  check(d.requestDisplay(), "requestDisplay");
+  d.drawPixel(3, 3, HANOVER_FLIPDOT_YELLOW); // Into a copy of page 0
+  d.invertRegion(40, 8, 8, 8);               // Into a copy of page 1
+  check(d.serviceDisplay(), "serviceDisplay");
+  check(!trace.getDot(3, 3) && !trace.getDot(40, 8),
+        "pass shows the frame as requested");
+
+  // The pass is over but the copies are not folded back yet
+  check(d.getPixel(3, 3) && d.getPixel(40, 8), "getPixel sees copies");
+  d.drawPixel(4, 3, HANOVER_FLIPDOT_YELLOW);
+  d.shiftRight(1);
+  check(d.getPixel(4, 3) && d.getPixel(5, 3) && d.getPixel(41, 8),
+        "drawing after the pass keeps earlier writes");
+  d.display();
+  check(panelShowsBuffer(trace, d), "display() shows every write");
+
+  check(d.requestDisplay(), "second requestDisplay");
+  d.clearDisplay();
+  check(d.serviceDisplay(), "second serviceDisplay");
+  check(trace.getDot(4, 3) && trace.getDot(41, 8),
+        "clear during the pass is not shown by it");
+  check(d.requestDisplay() && d.serviceDisplay(), "third pass");
+  check(panelShowsBuffer(trace, d) && !trace.getDot(4, 3),
+        "next pass shows the clear");
+}
+
+/*!
+    @brief  A tiled surface draws through the same page copies.
+    @return None (void).
+*/
+static void testTiled(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  Adafruit_HANOVER_FLIPDOT *panels[] = {&d};
+  HANOVER_FLIPDOT_Tiled tiled(panels, 1);
+  check(d.begin() && d.enableCopyOnWrite(1), "tiled setup");
+
+  check(d.requestDisplay(), "tiled requestDisplay");
+  tiled.drawPixel(10, 12, HANOVER_FLIPDOT_YELLOW);
+  check(d.serviceDisplay(), "tiled serviceDisplay");
+  check(!trace.getDot(10, 12), "tiled draw stays out of the pass");
+  check(tiled.getPixel(10, 12) && d.getPixel(10, 12), "tiled draw is kept");
+  check(d.requestDisplay() && d.serviceDisplay(), "tiled second pass");
+  check(trace.getDot(10, 12), "tiled draw shown by the next pass");
+}
+
+/*!
+    @brief  Draw a full-height bar per frame while another thread runs the
+            passes; every pass must show exactly one whole bar.
+    @return None (void).
+*/
+static void testStress(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  check(d.begin() && d.enableCopyOnWrite(1), "stress setup");
+
+  bool stop = false;
+  uint32_t passes = 0, torn = 0;
+  std::thread refresh([&] {
+    for (;;) {
+      bool last = __atomic_load_n(&stop, __ATOMIC_ACQUIRE);
+      if (d.serviceDisplay()) {
+        passes++;
+        uint8_t bars = 0;
+        for (uint8_t x = 0; x < W; x++) {
+          uint8_t n = 0;
+          for (uint8_t y = 0; y < H; y++)
+            n += trace.getDot(x, y);
+          if (n && (n != H))
+            torn++;
+          if (n)
+            bars++;
+        }
+        if (bars != 1)
+          torn++;
+      } else if (last) {
+        break;
+      }
+    }
+  });
+  for (uint16_t f = 0; f < FRAMES; f++) {
+    d.clearDisplay();
+    d.drawFastVLine(f % W, 0, H, HANOVER_FLIPDOT_YELLOW);
+    while (!d.requestDisplay())
+      std::this_thread::yield();
+  }
+  __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+  refresh.join();
+  check(passes > 0, "stress ran passes");
+  check(torn == 0, "no torn frames");
+  check(panelShowsBuffer(trace, d), "stress ends on the last frame");
+}
+
+int main(void) {
+  testNoLostWrites();
+  testTiled();
+  testStress();
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,104 @@
+/*!
+ * @file test_estimate.cpp
+ *
+ * estimateRefresh() against what HANOVER_FLIPDOT_VCDTrace measures when
+ * the refresh then runs: the dot count must be exact, counter advances
+ * may only err on the high side, and the predicted time too, by at most
+ * 5%. Covers sparse, dense, unknown and inverted content, and a frame
+ * passed in rather than the buffer.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#define W 96                    ///< Panel width
+#define H 16                    ///< Panel height
+#define SIZE (W * ((H + 7) / 8)) ///< Buffer bytes
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Estimate, refresh and compare.
+    @param  d
+            Display, with the change already drawn.
+    @param  trace
+            Trace of the display.
+    @param  name
+            Printed on failure.
+    @return None (void).
+*/
+static void compare(Adafruit_HANOVER_FLIPDOT &d,
+                    HANOVER_FLIPDOT_VCDTrace &trace, const char *name) {
+  HANOVER_FLIPDOT_RefreshCost cost;
+  d.estimateRefresh(&cost);
+  trace.reset();
+  d.display();
+  const HANOVER_FLIPDOT_TraceStats &st = trace.stats();
+  uint32_t advances = st.rising[HANOVER_FLIPDOT_TRACE_ROW] +
+                      st.rising[HANOVER_FLIPDOT_TRACE_COL];
+  char what[80];
+  snprintf(what, sizeof(what), "%s: dots exact (%lu vs %lu)", name,
+           (unsigned long)cost.dots,
+           (unsigned long)st.rising[HANOVER_FLIPDOT_TRACE_COIL]);
+  check(cost.dots == st.rising[HANOVER_FLIPDOT_TRACE_COIL], what);
+  snprintf(what, sizeof(what), "%s: advances not under (%lu vs %lu)", name,
+           (unsigned long)cost.advances, (unsigned long)advances);
+  check(cost.advances >= advances, what);
+  // Time: the per-page model only ever errs high, and then by little
+  snprintf(what, sizeof(what), "%s: time close (%lu vs %llu us)", name,
+           (unsigned long)cost.us, (unsigned long long)st.us);
+  check((cost.us >= st.us) && (cost.us * 20 <= st.us * 21), what);
+}
+
+int main(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  check(d.begin(true, 1, true), "begin");
+
+  d.drawPixel(50, 9, HANOVER_FLIPDOT_YELLOW);
+  compare(d, trace, "one dot");
+  d.drawRect(4, 2, 30, 12, HANOVER_FLIPDOT_YELLOW);
+  compare(d, trace, "rectangle");
+  for (uint16_t i = 0; i < SIZE; i++)
+    d.getBuffer()[i] = i * 37 + 11;
+  compare(d, trace, "dense");
+  d.markUnknown(10, 3, 20, 9);
+  compare(d, trace, "unknown region");
+  d.invertDisplay(true);
+  d.invertDisplay(false);
+  d.fillRect(60, 0, 20, H, HANOVER_FLIPDOT_INVERSE);
+  compare(d, trace, "inverted band");
+
+  // A frame passed in: estimate it, then copy it in and refresh
+  uint8_t frame[SIZE];
+  for (uint16_t i = 0; i < SIZE; i++)
+    frame[i] = (i & 4) ? 0xF0 : 0x0F;
+  HANOVER_FLIPDOT_RefreshCost a, b;
+  d.estimateRefresh(&a, frame);
+  memcpy(d.getBuffer(), frame, SIZE);
+  d.estimateRefresh(&b);
+  check(!memcmp(&a, &b, sizeof(a)), "a frame passed in is estimated alike");
+  compare(d, trace, "frame");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,70 @@
+/*!
+ * @file test_exercise.cpp
+ *
+ * Stuck-dot exercise budget: pulses follow the configured rate, never
+ * change what the panel shows, and a long idle gap earns the capped
+ * budget rather than wrapping the token count around.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#define W 96 ///< Panel width
+#define H 16 ///< Panel height
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+int main(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  d.begin();
+  d.fillRect(0, 0, W / 2, H, HANOVER_FLIPDOT_YELLOW);
+  d.display();
+  d.display(); // Let the exercise see every group as untouched
+
+  check(d.enableExercise(600), "enableExercise"); // 10 pulses a second
+  trace.reset();
+  uint32_t pulses = 0;
+  for (uint8_t i = 0; i < 100; i++) {
+    hostAdvance(100000);
+    pulses += d.exercise();
+  }
+  check((pulses >= 95) && (pulses <= 105), "10 s at 600/min is ~100 pulses");
+  check(trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL] == pulses,
+        "exercise() returns the pulses it drove");
+
+  // 65538 ms at 65535/min is 2^32 + 65534 token units: it must saturate
+  // at a second's worth (1092 pulses), not wrap to one pulse
+  check(d.enableExercise(65535), "enableExercise at full rate");
+  hostAdvance(65538000ULL);
+  pulses = d.exercise();
+  check(pulses > 1000, "long idle gap earns the capped budget");
+
+  bool same = true;
+  for (uint8_t y = 0; y < H; y++)
+    for (uint8_t x = 0; x < W; x++)
+      same = same && (trace.getDot(x, y) == d.getPixel(x, y));
+  check(same, "exercise leaves the picture unchanged");
+  return errors ? 1 : 0;
+}
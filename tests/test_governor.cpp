@@ -0,0 +1,117 @@
+/*!
+ * @file test_governor.cpp
+ *
+ * Frame-rate governor: a producer committing frames (from a simulated
+ * timer interrupt) much faster than the panel can flip them. Each
+ * displayLatest() must go to the newest frame committed when it starts,
+ * skipping those in between, so the panel never falls behind; the last
+ * frame must be the one shown at the end; and getFrameInterval() must
+ * track the measured refresh time.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#define W 96           ///< Panel width
+#define H 16           ///< Panel height
+#define FRAMES 300     ///< Frames the producer commits
+#define PERIOD_US 5000 ///< Time between commits
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+static Adafruit_HANOVER_FLIPDOT *panel; ///< Display being fed
+static uint16_t newest;                 ///< Last frame committed
+
+/*!
+    @brief  Simulated timer interrupt: draw the next frame (its number in
+            binary along row 0, plus a wide bar that moves, so every frame
+            costs many pulses), commit it and re-arm.
+    @return None (void).
+*/
+static void produce(void) {
+  uint16_t n = ++newest;
+  panel->clearDisplay();
+  for (uint8_t b = 0; b < 16; b++)
+    if (n & (1 << b))
+      panel->drawPixel(b, 0, HANOVER_FLIPDOT_YELLOW);
+  panel->fillRect(20 + (n * 7) % 60, 1, 16, H - 1, HANOVER_FLIPDOT_YELLOW);
+  panel->commitFrame();
+  if (n < FRAMES)
+    hostTimer(micros() + PERIOD_US, produce);
+}
+
+/*!
+    @brief  Read the frame number off the panel.
+    @param  t
+            Trace of the panel.
+    @return Frame number shown.
+*/
+static uint16_t shown(HANOVER_FLIPDOT_VCDTrace &t) {
+  uint16_t n = 0;
+  for (uint8_t b = 0; b < 16; b++)
+    if (t.getDot(b, 0))
+      n |= 1 << b;
+  return n;
+}
+
+int main(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  check(d.begin(true, 1, true) && d.enableTripleBuffering(), "setup");
+  panel = &d;
+  check(d.getFrameInterval() == 0, "no interval before the first refresh");
+
+  hostTimer(micros() + PERIOD_US, produce);
+  uint16_t refreshes = 0, last = 0;
+  uint32_t fastest = 0xFFFFFFFF, slowest = 0;
+  bool newest_taken = true, in_order = true;
+  while ((newest < FRAMES) || (last != newest)) {
+    uint16_t want = newest;
+    uint32_t start = micros();
+    if (!d.displayLatest()) {
+      hostAdvance(1000); // Idle refresh side
+      continue;
+    }
+    uint32_t took = micros() - start;
+    if (took < fastest)
+      fastest = took;
+    if (took > slowest)
+      slowest = took;
+    uint16_t n = shown(trace);
+    newest_taken &= n >= want;
+    in_order &= n > last;
+    last = n;
+    refreshes++;
+  }
+  check(newest_taken, "each refresh goes to the newest frame");
+  check(in_order, "frames are shown in order");
+  check(last == FRAMES, "the last frame ends up on the panel");
+  check(refreshes < FRAMES / 4, "intermediate frames are skipped");
+  check((d.getFrameInterval() >= fastest) && (d.getFrameInterval() <= slowest),
+        "getFrameInterval tracks the measured refreshes");
+  check(d.getFrameInterval() > 4 * PERIOD_US,
+        "the producer really was faster than the panel");
+  hostTimer(0, NULL);
+  return errors ? 1 : 0;
+}
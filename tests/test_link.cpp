@@ -0,0 +1,282 @@
+/*!
+ * @file test_link.cpp
+ *
+ * HANOVER_FLIPDOT_Link over a simulated serial line: packets arriving in
+ * fragments while copy-on-write moves pages land where they should, a
+ * packet with a bad CRC never reaches the panel (with or without triple
+ * buffering), and with triple buffering deltas keep applying to the
+ * picture last sent.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Link.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+#include <deque>
+#include <vector>
+
+#define W 96                    ///< Panel width
+#define H 16                    ///< Panel height
+#define SIZE (W * ((H + 7) / 8)) ///< Buffer bytes
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Both ends of a serial line: bytes queued by the test are read
+            by the link, replies are collected.
+*/
+class Line : public Stream {
+public:
+  int available(void) { return rx.size(); }
+  int read(void) {
+    if (rx.empty())
+      return -1;
+    int c = rx.front();
+    rx.pop_front();
+    return c;
+  }
+  int peek(void) { return rx.empty() ? -1 : rx.front(); }
+  size_t write(uint8_t c) {
+    tx.push_back(c);
+    return 1;
+  }
+  using Print::write;
+
+  std::deque<uint8_t> rx; ///< Bytes on their way to the link
+  std::vector<uint8_t> tx; ///< Replies from the link
+};
+
+/*!
+    @brief  Build a packet.
+    @param  type
+            Packet type, with or without HANOVER_FLIPDOT_LINK_COMMIT.
+    @param  x
+            Left column (PATCH and XOR only).
+    @param  page
+            Top page (PATCH and XOR only).
+    @param  w
+            Width in columns (PATCH and XOR only).
+    @param  pages
+            Height in pages (PATCH and XOR only).
+    @param  data
+            Payload, w bytes per page (SIZE bytes for a FRAME).
+    @return The packet, CRC included.
+*/
+static std::vector<uint8_t> packet(uint8_t type, uint8_t x, uint8_t page,
+                                   uint8_t w, uint8_t pages,
+                                   const uint8_t *data) {
+  std::vector<uint8_t> v = {HANOVER_FLIPDOT_LINK_SYNC0,
+                            HANOVER_FLIPDOT_LINK_SYNC1, type};
+  uint16_t len = SIZE;
+  if ((type & ~HANOVER_FLIPDOT_LINK_COMMIT) != HANOVER_FLIPDOT_LINK_FRAME) {
+    v.push_back(x);
+    v.push_back(page);
+    v.push_back(w);
+    v.push_back(pages);
+    len = w * pages;
+  }
+  v.insert(v.end(), data, data + len);
+  uint16_t crc = HANOVER_FLIPDOT_crc16(&v[2], v.size() - 2);
+  v.push_back(crc & 0xFF);
+  v.push_back(crc >> 8);
+  return v;
+}
+
+/*!
+    @brief  Put part of a packet on the line and let the link take it in.
+    @param  line
+            Line to send on.
+    @param  link
+            Receiver.
+    @param  v
+            Packet.
+    @param  from
+            First byte to send.
+    @param  to
+            One past the last byte to send.
+    @return The reply, or 0 if none was sent.
+*/
+static uint8_t send(Line &line, HANOVER_FLIPDOT_Link &link,
+                    const std::vector<uint8_t> &v, size_t from, size_t to) {
+  line.tx.clear();
+  line.rx.insert(line.rx.end(), v.begin() + from, v.begin() + to);
+  link.poll();
+  return line.tx.empty() ? 0 : line.tx.back();
+}
+
+/*!
+    @brief  Put a whole packet on the line.
+    @param  line
+            Line to send on.
+    @param  link
+            Receiver.
+    @param  v
+            Packet.
+    @return The reply, or 0 if none was sent.
+*/
+static uint8_t send(Line &line, HANOVER_FLIPDOT_Link &link,
+                    const std::vector<uint8_t> &v) {
+  return send(line, link, v, 0, v.size());
+}
+
+/*!
+    @brief  Compare the decoded panel with a picture.
+    @param  trace
+            Trace decoding the panel.
+    @param  pic
+            Picture in getBuffer() layout.
+    @return true if every dot matches.
+*/
+static bool panelShows(HANOVER_FLIPDOT_VCDTrace &trace, const uint8_t *pic) {
+  for (uint8_t y = 0; y < H; y++)
+    for (uint8_t x = 0; x < W; x++)
+      if (trace.getDot(x, y) != !!(pic[x + (y / 8) * W] & (1 << (y & 7))))
+        return false;
+  return true;
+}
+
+/*!
+    @brief  A PATCH split across poll()s while a copy-on-write refresh
+            ends and its page copy is folded back in between.
+    @return None (void).
+*/
+static void testFragmentsAcrossCopyOnWrite(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  Line line;
+  HANOVER_FLIPDOT_Link link(&d, &line, 60000); // Outlasts the refresh
+  check(d.begin() && d.enableCopyOnWrite(2), "setup");
+
+  uint8_t patch[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<uint8_t> v =
+      packet(HANOVER_FLIPDOT_LINK_PATCH, 20, 0, 8, 1, patch);
+  check(d.requestDisplay(), "requestDisplay");
+  send(line, link, v, 0, 11); // Header and half the payload, into a copy
+  check(d.serviceDisplay(), "serviceDisplay");
+  d.drawPixel(0, 15, HANOVER_FLIPDOT_YELLOW); // Folds the copy back
+  check(send(line, link, v, 11, v.size()) == HANOVER_FLIPDOT_LINK_ACK,
+        "fragmented patch accepted");
+  check(!memcmp(d.getBuffer() + 20, patch, 8),
+        "every byte of the fragmented patch landed");
+}
+
+/*!
+    @brief  A packet with a bad CRC is undone before anything can show
+            it, and only a FRAME is accepted afterwards.
+    @return None (void).
+*/
+static void testBadCrcNotShown(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  Line line;
+  HANOVER_FLIPDOT_Link link(&d, &line);
+  check(d.begin(), "setup");
+
+  uint8_t frame[SIZE];
+  for (uint16_t i = 0; i < SIZE; i++)
+    frame[i] = i * 37;
+  check(send(line, link,
+             packet(HANOVER_FLIPDOT_LINK_FRAME | HANOVER_FLIPDOT_LINK_COMMIT,
+                    0, 0, 0, 0, frame)) == HANOVER_FLIPDOT_LINK_ACK,
+        "frame accepted");
+  check(panelShows(trace, frame), "frame shown");
+
+  uint8_t patch[20];
+  memset(patch, 0xFF, sizeof(patch));
+  std::vector<uint8_t> v =
+      packet(HANOVER_FLIPDOT_LINK_PATCH, 30, 0, 10, 2, patch);
+  v[10] ^= 0x01; // Corrupt the payload
+  check(send(line, link, v) == HANOVER_FLIPDOT_LINK_NAK, "bad CRC refused");
+  check(!memcmp(d.getBuffer(), frame, SIZE), "buffer put back");
+  trace.reset();
+  d.display();
+  check(trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL] == 0,
+        "display() after a bad CRC drives nothing");
+
+  v = packet(HANOVER_FLIPDOT_LINK_PATCH, 30, 0, 10, 2, patch);
+  check(send(line, link, v) == HANOVER_FLIPDOT_LINK_NAK,
+        "patch refused until a frame arrives");
+  check(send(line, link, packet(HANOVER_FLIPDOT_LINK_FRAME, 0, 0, 0, 0,
+                                frame)) == HANOVER_FLIPDOT_LINK_ACK,
+        "frame resyncs");
+  check(send(line, link, v) == HANOVER_FLIPDOT_LINK_ACK,
+        "patch accepted again");
+}
+
+/*!
+    @brief  With triple buffering, XOR deltas committed one after another
+            each apply to the picture last sent, whichever slot comes
+            back, and a bad delta never reaches the front frame.
+    @return None (void).
+*/
+static void testTripleBufferedDeltas(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  Line line;
+  HANOVER_FLIPDOT_Link link(&d, &line);
+  check(d.begin() && d.enableTripleBuffering(), "setup");
+
+  uint8_t pic[SIZE];
+  for (uint16_t i = 0; i < SIZE; i++)
+    pic[i] = i * 13;
+  check(send(line, link,
+             packet(HANOVER_FLIPDOT_LINK_FRAME | HANOVER_FLIPDOT_LINK_COMMIT,
+                    0, 0, 0, 0, pic)) == HANOVER_FLIPDOT_LINK_ACK,
+        "frame accepted");
+  check(d.displayLatest() && panelShows(trace, pic), "frame shown");
+
+  bool ok = true;
+  for (uint8_t n = 0; n < 20; n++) {
+    uint8_t x = (n * 17) % (W - 6), page = n & 1, delta[6];
+    for (uint8_t i = 0; i < 6; i++)
+      delta[i] = 1 << ((n + i) & 7);
+    std::vector<uint8_t> v =
+        packet(HANOVER_FLIPDOT_LINK_XOR | HANOVER_FLIPDOT_LINK_COMMIT, x,
+               page, 6, 1, delta);
+    ok &= send(line, link, v) == HANOVER_FLIPDOT_LINK_ACK;
+    for (uint8_t i = 0; i < 6; i++)
+      pic[page * W + x + i] ^= delta[i];
+    ok &= !memcmp(d.getBuffer(), pic, SIZE);
+    if (n % 3) // Let some commits pile up unseen
+      d.displayLatest();
+  }
+  check(ok, "every delta applied to the picture last sent");
+  d.displayLatest();
+  check(panelShows(trace, pic), "panel shows the last picture");
+
+  uint8_t delta[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+  std::vector<uint8_t> v = packet(
+      HANOVER_FLIPDOT_LINK_XOR | HANOVER_FLIPDOT_LINK_COMMIT, 0, 0, 6, 1,
+      delta);
+  v.back() ^= 0x01;
+  check(send(line, link, v) == HANOVER_FLIPDOT_LINK_NAK, "bad CRC refused");
+  check(!d.displayLatest() && panelShows(trace, pic),
+        "bad delta never committed");
+}
+
+int main(void) {
+  testFragmentsAcrossCopyOnWrite();
+  testBadCrcNotShown();
+  testTripleBufferedDeltas();
+  return errors ? 1 : 0;
+}
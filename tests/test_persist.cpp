@@ -0,0 +1,162 @@
+/*!
+ * @file test_persist.cpp
+ *
+ * HANOVER_FLIPDOT_Persist against two in-memory backends: one that
+ * behaves like real EEPROM (every write durable at once) and one like
+ * flash-emulated EEPROM (writes land in a RAM cache, commit() copies it
+ * to flash). Checks warm boots, the flash commit count per save, and
+ * what a power cut between a change and the next save leaves behind.
+ * Like a port to a board without EEPROM.h, the backends override only
+ * read(), write() and commit().
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Persist.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#define W 96      ///< Panel width
+#define H 16      ///< Panel height
+#define ADDR 16   ///< Record offset
+#define NV 1024   ///< Bytes of simulated non-volatile memory
+
+static uint8_t flash[NV]; ///< Durable contents
+static uint8_t cache[NV]; ///< Flash-emulated EEPROM's RAM copy
+static int commits;       ///< Flash commits so far
+static int errors = 0;    ///< Failed checks
+
+/*!
+    @brief  Store backed by the arrays above.
+*/
+class RamStore : public HANOVER_FLIPDOT_Persist {
+public:
+  /*!
+      @brief  Constructor.
+      @param  d
+              Display.
+      @param  emulated
+              true for flash-emulated EEPROM, false for real EEPROM.
+  */
+  RamStore(Adafruit_HANOVER_FLIPDOT *d, bool emulated)
+      : HANOVER_FLIPDOT_Persist(d, ADDR, 1000), emulated(emulated) {
+    memcpy(cache, flash, NV); // EEPROM.begin() reads flash into RAM
+  }
+
+protected:
+  uint8_t read(uint16_t a) { return emulated ? cache[a] : flash[a]; }
+  void write(uint16_t a, uint8_t v) { (emulated ? cache : flash)[a] = v; }
+  void commit(void) {
+    if (emulated) {
+      memcpy(flash, cache, NV);
+      commits++;
+    }
+  }
+
+  bool emulated; ///< Backend type
+};
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Boot a display with a store.
+    @param  emulated
+            Backend type.
+    @return true if begin() trusted the saved state: no dot driven and
+            none left unknown.
+*/
+static bool bootTrusted(bool emulated) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  RamStore store(&d, emulated);
+  d.begin();
+  return !trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL] &&
+         !d.anyUnknown();
+}
+
+/*!
+    @brief  Save, change, save again on one backend, checking commits and
+            what a warm boot restores.
+    @param  emulated
+            Backend type.
+    @return None (void).
+*/
+static void testBackend(bool emulated) {
+  memset(flash, 0xFF, NV);
+  commits = 0;
+  {
+    Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+    HANOVER_FLIPDOT_VCDTrace trace(&d);
+    RamStore store(&d, emulated);
+    check(d.begin(), "cold begin");
+    check(d.anyUnknown(), "cold boot leaves the panel unknown");
+    d.fillRect(0, 0, 10, 10, HANOVER_FLIPDOT_YELLOW);
+    d.display();
+    check(store.save(), "save");
+    int saved = commits;
+
+    // A change: the record goes stale, but nothing is committed until the
+    // next save, and that save commits once
+    d.drawPixel(50, 10, HANOVER_FLIPDOT_YELLOW);
+    d.display();
+    check(commits == saved, "no commit inside the refresh");
+    check(flash[ADDR] == (emulated ? 'H' : 0),
+          "invalidate durable only on real EEPROM");
+    hostAdvance(2000000);
+    check(store.update(), "update after the interval");
+    check(commits == saved + (emulated ? 1 : 0), "one commit per save");
+    check(!store.update(), "nothing to save without a change");
+  }
+
+  // Warm boot: the saved state is trusted, nothing is pulsed
+  check(bootTrusted(emulated), "warm boot trusts the saved state");
+
+  // Change after the last save, then power cut (no save)
+  {
+    Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+    RamStore store(&d, emulated);
+    d.begin();
+    d.drawPixel(0, 15, HANOVER_FLIPDOT_YELLOW);
+    d.display();
+  }
+  if (emulated)
+    check(bootTrusted(emulated),
+          "flash: power cut restores the last saved state");
+  else
+    check(!bootTrusted(emulated),
+          "EEPROM: power cut after a change leaves the panel unknown");
+
+  // A corrupt record is never trusted
+  {
+    Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+    RamStore store(&d, emulated);
+    d.begin();
+    d.display();
+    check(store.save(), "save before corruption");
+  }
+  flash[ADDR + HANOVER_FLIPDOT_PERSIST_HEADER + 20] ^= 1;
+  check(!bootTrusted(emulated), "corrupt record is not trusted");
+}
+
+int main(void) {
+  testBackend(false);
+  testBackend(true);
+  return errors ? 1 : 0;
+}
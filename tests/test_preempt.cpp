@@ -0,0 +1,116 @@
+/*!
+ * @file test_preempt.cpp
+ *
+ * Refresh priorities: a display() with a higher priority, called from a
+ * simulated timer interrupt while a refresh is running, stops it at the
+ * next dot and restarts toward the new buffer, so the rows the interrupt
+ * changed are right within a few dots' time instead of after the rest of
+ * the pass. One with the same priority waits for the pass to finish.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#define W 96 ///< Panel width
+#define H 16 ///< Panel height
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+static Adafruit_HANOVER_FLIPDOT *panel; ///< Display the interrupt draws to
+static HANOVER_FLIPDOT_VCDTrace *trace; ///< What reached the panel
+static uint8_t isr_priority;            ///< Priority the interrupt uses
+static uint32_t isr_runs;               ///< Interrupts taken
+static bool top_ok;                     ///< Top rows right when sampled
+static bool sampled;                    ///< sample() has run
+
+/*!
+    @brief  Check the top four rows show the interrupt's box.
+    @return true if they do.
+*/
+static bool topShowsBox(void) {
+  for (uint8_t y = 0; y < 4; y++)
+    for (uint8_t x = 0; x < W; x++)
+      if (trace->getDot(x, y) != (x < 4))
+        return false;
+  return true;
+}
+
+/*!
+    @brief  Simulated timer interrupt, a while after urgent(): see whether
+            its change has reached the panel yet.
+    @return None (void).
+*/
+static void sample(void) {
+  sampled = true;
+  top_ok = topShowsBox();
+}
+
+/*!
+    @brief  Simulated timer interrupt: replace the top rows with a small
+            box and ask for it to be shown.
+    @return None (void).
+*/
+static void urgent(void) {
+  isr_runs++;
+  panel->fillRect(0, 0, W, 4, HANOVER_FLIPDOT_BLACK);
+  panel->fillRect(0, 0, 4, 4, HANOVER_FLIPDOT_YELLOW);
+  hostTimer(micros() + 200000, sample);
+  panel->display(isr_priority);
+}
+
+/*!
+    @brief  Start showing a full frame, interrupt it partway and finish.
+    @param  priority
+            Priority of the interrupt's display().
+    @return None (void).
+*/
+static void run(uint8_t priority) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace t(&d);
+  check(d.begin(true, 1, true), "begin");
+  panel = &d;
+  trace = &t;
+  isr_priority = priority;
+  isr_runs = 0;
+  top_ok = sampled = false;
+  d.fillScreen(HANOVER_FLIPDOT_YELLOW);
+  hostTimer(micros() + 100000, urgent); // About a tenth of the way in
+  d.display(0);
+  check((isr_runs == 1) && sampled, "interrupts taken during the refresh");
+
+  bool end_ok = topShowsBox();
+  for (uint8_t y = 4; y < H; y++)
+    for (uint8_t x = 0; x < W; x++)
+      end_ok &= trace->getDot(x, y);
+  check(end_ok, "panel ends on the buffer");
+  hostTimer(0, NULL);
+}
+
+int main(void) {
+  run(1);
+  check(top_ok, "higher priority: urgent rows shown at once");
+  run(0);
+  check(!top_ok, "same priority: urgent rows wait for the pass");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+/*!
+ * @file test_progmem_chunks.cpp
+ *
+ * combineBitmap() as built for AVR and ESP8266, where PROGMEM is copied
+ * out 32 bytes at a time (linked against the library built with
+ * HANOVER_FLIPDOT_PROGMEM_CHUNKS), on panels narrow and wide enough
+ * that a uint8_t column counter would wrap.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+
+#define H 16 ///< Panel height
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  XOR a bitmap into a panel of the given width and check every
+            byte.
+    @param  w
+            Panel width.
+    @return true if the buffer is exactly the old contents XOR bitmap.
+*/
+static bool combine(uint8_t w) {
+  Adafruit_HANOVER_FLIPDOT d(w, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  if (!d.begin(false))
+    return false;
+  uint16_t size = w * ((H + 7) / 8);
+  uint8_t *bitmap = (uint8_t *)malloc(size), *want = (uint8_t *)malloc(size);
+  uint8_t *buf = d.getBuffer();
+  for (uint16_t i = 0; i < size; i++) {
+    buf[i] = i * 7;
+    bitmap[i] = i * 13 + 1;
+    want[i] = buf[i] ^ bitmap[i];
+  }
+  d.combineBitmap(bitmap, HANOVER_FLIPDOT_OP_XOR);
+  bool ok = !memcmp(d.getBuffer(), want, size);
+  free(bitmap);
+  free(want);
+  return ok;
+}
+
+int main(void) {
+  check(combine(96), "96 columns, three whole chunks");
+  check(combine(100), "100 columns, a short last chunk");
+  check(combine(240), "240 columns, counter passes 255");
+  check(combine(255), "255 columns, the widest panel");
+  return errors ? 1 : 0;
+}
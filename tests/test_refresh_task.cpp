@@ -0,0 +1,72 @@
+/*!
+ * @file test_refresh_task.cpp
+ *
+ * Stress test of HANOVER_FLIPDOT_RefreshTask on its host thread backend:
+ * the main thread draws and commits frames (some at a higher priority,
+ * to preempt the refresh in flight) while the task drives the panel. The
+ * panel must end up showing the last frame committed.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_RefreshTask.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+#include <thread>
+
+#define W 96       ///< Panel width
+#define H 16       ///< Panel height
+#define FRAMES 400 ///< Frames committed
+
+/*!
+    @brief  Draw frame f: its number as text plus a moving bar.
+    @param  d
+            Display to draw into.
+    @param  f
+            Frame number.
+    @return None (void).
+*/
+static void drawFrame(Adafruit_HANOVER_FLIPDOT &d, uint16_t f) {
+  d.clearDisplay();
+  d.setTextColor(HANOVER_FLIPDOT_YELLOW);
+  d.setCursor(0, 0);
+  d.print((unsigned long)f);
+  d.fillRect(f % W, 8, 12, 8, HANOVER_FLIPDOT_YELLOW);
+}
+
+int main(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  HANOVER_FLIPDOT_RefreshTask task(&d);
+  if (!d.begin() || !task.begin()) {
+    puts("setup failed");
+    return 1;
+  }
+  for (uint16_t f = 1; f <= FRAMES; f++) {
+    drawFrame(d, f);
+    d.commitFrame((f % 10) ? 0 : 1);
+    for (uint8_t i = 0; i < (f & 7); i++) // Vary the race
+      std::this_thread::yield();
+  }
+  task.end();
+
+  int errors = 0;
+  drawFrame(d, FRAMES);
+  for (uint8_t y = 0; y < H; y++)
+    for (uint8_t x = 0; x < W; x++)
+      if (trace.getDot(x, y) != d.getPixel(x, y))
+        errors++;
+  if (errors)
+    printf("%d dots differ from the last frame\n", errors);
+  uint32_t shown = task.framesShown();
+  if (!shown || (shown > FRAMES)) {
+    printf("%lu frames shown\n", (unsigned long)shown);
+    errors++;
+  }
+  printf("%lu of %u frames shown\n", (unsigned long)shown, FRAMES);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+/*!
+ * @file test_scenes.cpp
+ *
+ * Golden-frame regression scenes. Each scene draws a baseline, displays
+ * it, then draws a change and displays again; the trace decodes what the
+ * driver put on the lines into a simulated panel, which must match
+ * golden/<scene>.pbm, and the second display() must stay within the
+ * scene's coil pulse and simulated time budget.
+ *
+ * Run with --update to rewrite the goldens and print the measured costs
+ * (budgets are kept in the table below, not updated automatically).
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#define W 96 ///< Panel width of every scene
+#define H 16 ///< Panel height of every scene
+
+typedef void (*Draw)(Adafruit_HANOVER_FLIPDOT &d);
+
+/*!
+    @brief  One scene: how to draw it and what the change may cost.
+*/
+struct Scene {
+  const char *name;    ///< Golden file is golden/<name>.pbm
+  Draw baseline;       ///< Drawn and displayed before measuring
+  Draw change;         ///< Drawn and displayed while measuring
+  uint32_t max_pulses; ///< Coil pulse budget of the change
+  uint64_t max_us;     ///< Simulated time budget of the change
+};
+
+static void nothing(Adafruit_HANOVER_FLIPDOT &) {}
+
+static void rect(Adafruit_HANOVER_FLIPDOT &d) {
+  d.drawRect(4, 2, 30, 12, HANOVER_FLIPDOT_YELLOW);
+}
+
+static void circle(Adafruit_HANOVER_FLIPDOT &d) {
+  d.fillCircle(48, 8, 7, HANOVER_FLIPDOT_YELLOW);
+}
+
+static void diagonal(Adafruit_HANOVER_FLIPDOT &d) {
+  d.drawLine(0, 0, W - 1, H - 1, HANOVER_FLIPDOT_YELLOW);
+  d.drawLine(0, H - 1, W - 1, 0, HANOVER_FLIPDOT_YELLOW);
+}
+
+static void checkerboard(Adafruit_HANOVER_FLIPDOT &d) {
+  for (int16_t y = 0; y < H; y++)
+    for (int16_t x = 0; x < W; x++)
+      if ((x ^ y) & 1)
+        d.drawPixel(x, y, HANOVER_FLIPDOT_YELLOW);
+}
+
+static void clear(Adafruit_HANOVER_FLIPDOT &d) { d.clearDisplay(); }
+
+static void invert(Adafruit_HANOVER_FLIPDOT &d) {
+  d.invertRegion(40, 0, 24, H);
+}
+
+static void shift(Adafruit_HANOVER_FLIPDOT &d) { d.shiftLeft(5); }
+
+static void combine(Adafruit_HANOVER_FLIPDOT &d) {
+  static uint8_t src[W * ((H + 7) / 8)];
+  for (uint16_t i = 0; i < sizeof(src); i++)
+    src[i] = (i & 4) ? 0xF0 : 0x0F;
+  d.combineBuffer(src, HANOVER_FLIPDOT_OP_XOR);
+}
+
+// Pulse budgets are exact: a diff refresh pulses each changed dot once.
+// Time budgets allow about 2% for counter walks and resets.
+static const Scene scenes[] = {
+    {"rect", nothing, rect, 80, 65000},
+    {"circle", nothing, circle, 177, 137000},
+    {"diagonal", nothing, diagonal, 192, 162000},
+    {"checker_clear", checkerboard, clear, 768, 498000},
+    {"invert", diagonal, invert, 384, 262000},
+    {"shift", rect, shift, 48, 47000},
+    {"combine", circle, combine, 768, 497000},
+};
+
+/*!
+    @brief  Run one scene.
+    @param  s
+            Scene to run.
+    @param  update
+            Rewrite the golden instead of comparing.
+    @return true if the scene passes.
+*/
+static bool run(const Scene &s, bool update) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  if (!d.begin()) {
+    printf("%s: begin() failed\n", s.name);
+    return false;
+  }
+  s.baseline(d);
+  d.display();
+  trace.reset();
+  s.change(d);
+  d.display();
+
+  char path[256];
+  snprintf(path, sizeof(path), "%s%s.pbm", GOLDEN_DIR, s.name);
+  const HANOVER_FLIPDOT_TraceStats &st = trace.stats();
+  uint32_t pulses = st.rising[HANOVER_FLIPDOT_TRACE_COIL];
+  if (update) {
+    printf("%s: %lu pulses, %llu us\n", s.name, (unsigned long)pulses,
+           (unsigned long long)st.us);
+    return trace.writePBM(path);
+  }
+  bool ok = true;
+  int32_t diff = trace.comparePBM(path);
+  if (diff) {
+    printf("%s: %ld dots differ from %s\n", s.name, (long)diff, path);
+    ok = false;
+  }
+  if (!trace.withinBudget(s.max_pulses, s.max_us)) {
+    printf("%s: over budget, %lu/%lu pulses, %llu/%llu us\n", s.name,
+           (unsigned long)pulses, (unsigned long)s.max_pulses,
+           (unsigned long long)st.us, (unsigned long long)s.max_us);
+    ok = false;
+  }
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  bool update = (argc > 1) && !strcmp(argv[1], "--update");
+  int failed = 0;
+  for (size_t i = 0; i < sizeof(scenes) / sizeof(scenes[0]); i++)
+    if (!run(scenes[i], update))
+      failed++;
+  if (failed)
+    printf("%d scene(s) failed\n", failed);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+/*!
+ * @file test_streaming.cpp
+ *
+ * The refresh helpers in streaming mode, which has no buffer, shadow or
+ * unknown map: estimateRefresh() and refreshDot() report nothing instead
+ * of reading them (a transition, which drives dots through refreshDot(),
+ * does nothing), and markUnknown() and redriveSegment() re-drive the
+ * whole panel through displayState().
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+#include "HANOVER_FLIPDOT_Transition.h"
+
+#define W 96 ///< Panel width
+#define H 16 ///< Panel height
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Streaming renderer: a bar at column state.
+    @param  page
+            Page to render.
+    @param  state
+            Column of the bar.
+    @param  out
+            WIDTH bytes of page to fill.
+    @param  ctx
+            Unused.
+    @return None (void).
+*/
+static void bar(uint8_t page, uint32_t state, uint8_t *out, void *ctx) {
+  (void)page;
+  (void)ctx;
+  memset(out, 0, W);
+  out[state % W] = 0xFF;
+}
+
+/*!
+    @brief  Coil pulses since the trace was last reset, then reset it.
+    @param  trace
+            Trace to read.
+    @return Pulse count.
+*/
+static uint32_t pulses(HANOVER_FLIPDOT_VCDTrace &trace) {
+  uint32_t n = trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL];
+  trace.reset();
+  return n;
+}
+
+int main(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  d.setRenderer(bar);
+  check(d.begin(), "begin");
+  d.displayState(5);
+  pulses(trace);
+  check(!d.anyUnknown(), "nothing unknown once shown");
+
+  HANOVER_FLIPDOT_RefreshCost cost;
+  memset(&cost, 0xFF, sizeof(cost));
+  d.estimateRefresh(&cost);
+  check(!cost.dots && !cost.advances && !cost.resets && !cost.us,
+        "estimateRefresh reports nothing");
+  HANOVER_FLIPDOT_Transition wipe(&d);
+  wipe.begin(HANOVER_FLIPDOT_WIPE);
+  while (wipe.step())
+    ;
+  check(pulses(trace) == 0, "transition drives nothing");
+
+  check(d.markUnknown(10, 0, 4, 8), "markUnknown");
+  check(d.anyUnknown(), "anyUnknown after markUnknown");
+  d.displayState(5);
+  check(pulses(trace) == W * H, "next state drives every dot");
+  check(!d.anyUnknown(), "nothing unknown after the re-drive");
+  check(trace.getDot(5, 15) && !trace.getDot(6, 15), "state still shown");
+
+  d.displayState(7);
+  pulses(trace);
+  check(d.redriveSegment(), "redriveSegment");
+  check(pulses(trace) == W * H, "redriveSegment drives every dot");
+  check(!d.anyUnknown() && trace.getDot(7, 0) && !trace.getDot(5, 0),
+        "redriveSegment shows the current state");
+  return errors ? 1 : 0;
+}
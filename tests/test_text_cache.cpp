@@ -0,0 +1,87 @@
+/*!
+ * @file test_text_cache.cpp
+ *
+ * getTextExtent() cache: a repeat measurement is served from the cache
+ * (shown by editing the font in place, which the cache cannot see), a
+ * change of text size, string or font misses it, and clearTextCache()
+ * and round-robin replacement drop old entries.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+
+#define W 96 ///< Panel width
+#define H 16 ///< Panel height
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+static uint8_t bitmap[8] = {0};              ///< Ink is never read
+static GFXglyph glyphs[2] = {{0, 3, 5, 4, 0, -5}, {0, 3, 5, 4, 0, -5}};
+static GFXfont font = {bitmap, glyphs, 'A', 'B', 8}; ///< 'A' and 'B' only
+
+/*!
+    @brief  Measure a string's width.
+    @param  d
+            Display to measure with.
+    @param  s
+            String.
+    @return Width from getTextExtent().
+*/
+static uint16_t width(Adafruit_HANOVER_FLIPDOT &d, const char *s) {
+  uint16_t w, h;
+  d.getTextExtent(s, &w, &h);
+  return w;
+}
+
+int main(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  check(d.begin(), "begin");
+  d.setTextWrap(false);
+  d.setFont(&font);
+
+  check(width(d, "AB") == 7, "first measurement");
+  glyphs[1].width = 5; // Behind the cache's back
+  check(width(d, "AB") == 7, "repeat is a cache hit");
+  check(width(d, "BB") == 9, "other string of the same length misses");
+  d.setTextSize(2);
+  check(width(d, "AB") == 18, "text size change misses");
+  d.setTextSize(1);
+  d.setFont(NULL);
+  check(width(d, "AB") == 12, "font change misses");
+  d.setFont(&font);
+  check(width(d, "AB") == 7, "back to the old key hits again");
+  d.clearTextCache();
+  check(width(d, "AB") == 9, "clearTextCache drops every entry");
+
+  glyphs[1].width = 3;
+  char s[3] = "AA";
+  for (uint8_t i = 0; i < HANOVER_FLIPDOT_TEXT_CACHE_SIZE; i++) {
+    s[1] = (i & 1) ? 'A' : 'B';
+    s[0] = (i & 2) ? 'A' : 'B';
+    d.setTextSize(2 + i / 4); // Eight new keys, none of them "AB" at 1
+    width(d, s);
+  }
+  d.setTextSize(1);
+  check(width(d, "AB") == 7, "oldest entry replaced round robin");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+/*!
+ * @file test_ticker.cpp
+ *
+ * HANOVER_FLIPDOT_Ticker: the band scrolls in place, dots outside it are
+ * never touched, each step pulses only the band dots that changed, and a
+ * band placed partly or wholly off the panel is cut to it.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Ticker.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#define W 96                    ///< Panel width
+#define H 16                    ///< Panel height
+#define SIZE (W * ((H + 7) / 8)) ///< Buffer bytes
+#define BX 10                   ///< Band left column
+#define BY 4                    ///< Band top row
+#define BW 40                   ///< Band width
+#define BH 8                    ///< Band height
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Check whether a dot lies in the test band.
+    @param  x
+            Column.
+    @param  y
+            Row.
+    @return true if inside.
+*/
+static bool inBand(uint8_t x, uint8_t y) {
+  return (x >= BX) && (x < BX + BW) && (y >= BY) && (y < BY + BH);
+}
+
+/*!
+    @brief  A pattern around (and under) the band, so moved or clobbered
+            dots show.
+    @param  d
+            Display to draw into.
+    @return None (void).
+*/
+static void background(Adafruit_HANOVER_FLIPDOT &d) {
+  for (uint8_t y = 0; y < H; y++)
+    for (uint8_t x = 0; x < W; x++)
+      if (((x * 7) ^ (y * 3)) & 4)
+        d.drawPixel(x, y, HANOVER_FLIPDOT_YELLOW);
+}
+
+/*!
+    @brief  Scroll a message through a band in the middle of the panel.
+    @return None (void).
+*/
+static void testScroll(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  HANOVER_FLIPDOT_Ticker ticker(&d, BY, BH, BX, BW);
+  check(d.begin() && ticker.begin(), "setup");
+  background(d);
+  d.display();
+  ticker.setText("HELLO");
+
+  bool before[H][W], outside = true, in_place = true, exact = true;
+  uint32_t total = 0;
+  for (uint8_t y = 0; y < H; y++)
+    for (uint8_t x = 0; x < W; x++)
+      before[y][x] = trace.getDot(x, y);
+  for (uint8_t n = 0; n < 60; n++) {
+    trace.reset();
+    ticker.step();
+    uint32_t changed = 0;
+    for (uint8_t y = 0; y < H; y++) {
+      for (uint8_t x = 0; x < W; x++) {
+        bool now = trace.getDot(x, y);
+        changed += now != before[y][x];
+        if (!inBand(x, y))
+          outside &= now == before[y][x];
+        else if (x < BX + BW - 1)
+          in_place &= now == before[y][x + 1];
+      }
+    }
+    total += changed;
+    exact &= trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL] == changed;
+    for (uint8_t y = 0; y < H; y++)
+      for (uint8_t x = 0; x < W; x++)
+        before[y][x] = trace.getDot(x, y);
+  }
+  check(total > 0, "the message scrolled through");
+  check(outside, "dots outside the band never change");
+  check(in_place, "band content moves one column left per step");
+  check(exact, "each step pulses exactly the band dots that changed");
+}
+
+/*!
+    @brief  Bands partly or wholly off the panel.
+    @return None (void).
+*/
+static void testClipped(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_Ticker off(&d, 0, 8, W + 4, 10);
+  HANOVER_FLIPDOT_Ticker below(&d, H, 8, 0, 10);
+  HANOVER_FLIPDOT_Ticker edge(&d, 8, 8, W - 6, 50);
+  check(d.begin() && off.begin() && below.begin() && edge.begin(), "setup");
+  background(d);
+  uint8_t copy[SIZE];
+  memcpy(copy, d.getBuffer(), SIZE);
+  off.setText("HELLO");
+  below.setText("HELLO");
+  edge.setText("HELLO");
+  bool ok = true;
+  for (uint8_t n = 0; n < 20; n++) {
+    off.step(1, false);
+    below.step(1, false);
+    ok &= !memcmp(copy, d.getBuffer(), SIZE);
+  }
+  check(ok, "bands off the panel draw nothing");
+  for (uint8_t n = 0; n < 20; n++)
+    edge.step(1, false);
+  ok = true;
+  for (uint8_t y = 0; y < H; y++)
+    for (uint8_t x = 0; x < W; x++)
+      if ((x < W - 6) || (y < 8))
+        ok &= d.getPixel(x, y) == !!(copy[x + (y / 8) * W] & (1 << (y & 7)));
+  check(ok, "band running off the edge is cut to the panel");
+}
+
+int main(void) {
+  testScroll();
+  testClipped();
+  return errors ? 1 : 0;
+}
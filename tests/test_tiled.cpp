@@ -0,0 +1,130 @@
+/*!
+ * @file test_tiled.cpp
+ *
+ * HANOVER_FLIPDOT_Tiled routing: in every rotation, side by side and
+ * stacked, with panels of different sizes, each surface dot lands in
+ * exactly one bit of exactly one panel, where the rotation puts it, reads
+ * back through getPixel(), and display() refreshes only that panel.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Tiled.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Count the set bits in a panel's buffer.
+    @param  d
+            Panel.
+    @return Number of yellow dots.
+*/
+static uint16_t lit(Adafruit_HANOVER_FLIPDOT &d) {
+  uint16_t n = 0, size = d.width() * ((d.height() + 7) / 8);
+  const uint8_t *b = d.getBuffer();
+  for (uint16_t i = 0; i < size; i++)
+    n += __builtin_popcount(b[i]);
+  return n;
+}
+
+/*!
+    @brief  Route every dot of a two-panel surface in all four rotations.
+    @param  vertical
+            Stack the panels instead of placing them side by side.
+    @return None (void).
+*/
+static void run(bool vertical) {
+  // Different sizes along the tiling axis, so the split is not symmetric
+  Adafruit_HANOVER_FLIPDOT a(vertical ? 48 : 40, vertical ? 8 : 16, 2, 3, 4,
+                             5, 6, 10, 11, 12, 13);
+  Adafruit_HANOVER_FLIPDOT b(vertical ? 48 : 56, 16, 2, 3, 4, 5, 6, 10, 11,
+                             12, 13);
+  HANOVER_FLIPDOT_VCDTrace ta(&a), tb(&b);
+  check(a.begin() && b.begin(), "begin");
+  Adafruit_HANOVER_FLIPDOT *panels[2] = {&a, &b};
+  HANOVER_FLIPDOT_Tiled t(panels, 2, vertical);
+  int16_t tw = vertical ? 48 : 96, th = vertical ? 24 : 16;
+  check((t.width() == tw) && (t.height() == th), "surface size");
+  a.display();
+  b.display();
+
+  bool routed = true, readback = true, refreshed = true;
+  for (uint8_t r = 0; r < 4; r++) {
+    t.setRotation(r);
+    for (int16_t y = 0; y < t.height(); y++) {
+      for (int16_t x = 0; x < t.width(); x++) {
+        // Where the rotation puts (x, y) on the unrotated surface
+        int16_t ux = x, uy = y;
+        if (r == 1) {
+          ux = tw - 1 - y;
+          uy = x;
+        } else if (r == 2) {
+          ux = tw - 1 - x;
+          uy = th - 1 - y;
+        } else if (r == 3) {
+          ux = y;
+          uy = th - 1 - x;
+        }
+        bool second = vertical ? (uy >= 8) : (ux >= 40);
+        Adafruit_HANOVER_FLIPDOT &p = second ? b : a;
+        int16_t px = ux - ((second && !vertical) ? 40 : 0);
+        int16_t py = uy - ((second && vertical) ? 8 : 0);
+
+        t.drawPixel(x, y, HANOVER_FLIPDOT_YELLOW);
+        routed &= p.getPixel(px, py) && (lit(a) + lit(b) == 1);
+        readback &= t.getPixel(x, y);
+        if (!(x % 13) && !(y % 5)) { // A sample: refreshing is slow
+          ta.reset();
+          tb.reset();
+          t.display();
+          HANOVER_FLIPDOT_VCDTrace &hit = second ? tb : ta;
+          HANOVER_FLIPDOT_VCDTrace &miss = second ? ta : tb;
+          refreshed &= hit.getDot(px, py) &&
+                       (hit.stats().rising[HANOVER_FLIPDOT_TRACE_COIL] == 1) &&
+                       (miss.stats().rising[HANOVER_FLIPDOT_TRACE_COIL] == 0);
+          t.drawPixel(x, y, HANOVER_FLIPDOT_BLACK);
+          t.display();
+        } else {
+          t.drawPixel(x, y, HANOVER_FLIPDOT_BLACK);
+        }
+      }
+    }
+  }
+  char what[64];
+  snprintf(what, sizeof(what), "%s: each dot routed to its panel bit",
+           vertical ? "stacked" : "side by side");
+  check(routed, what);
+  snprintf(what, sizeof(what), "%s: getPixel reads it back",
+           vertical ? "stacked" : "side by side");
+  check(readback, what);
+  snprintf(what, sizeof(what), "%s: display() refreshes only that panel",
+           vertical ? "stacked" : "side by side");
+  check(refreshed, what);
+}
+
+int main(void) {
+  run(false);
+  run(true);
+  return errors ? 1 : 0;
+}
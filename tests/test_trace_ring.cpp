@@ -0,0 +1,104 @@
+/*!
+ * @file test_trace_ring.cpp
+ *
+ * Trace ring, built with HANOVER_FLIPDOT_TRACE_RING = 64: dumpTrace()
+ * prints every entry while the ring is filling, then the last 64, oldest
+ * first, including after the 16-bit head index has wrapped past 65536
+ * events.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include <string>
+
+#define RING HANOVER_FLIPDOT_TRACE_RING ///< Entries kept
+
+static int errors = 0;  ///< Failed checks
+static uint32_t events; ///< Events recorded so far
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Collects what dumpTrace() prints.
+*/
+class Capture : public Print {
+public:
+  size_t write(uint8_t c) {
+    text += (char)c;
+    return 1;
+  }
+  using Print::write;
+
+  std::string text; ///< Everything printed
+};
+
+/*!
+    @brief  Record events up to a total, each numbered by its code and
+            arguments (application codes, from 0x80 up).
+    @param  total
+            Events recorded so far once done.
+    @return None (void).
+*/
+static void record(uint32_t total) {
+  for (; events < total; events++)
+    Adafruit_HANOVER_FLIPDOT::traceEvent(0x80 | ((events >> 16) & 0x7F),
+                                         events & 0xFF, (events >> 8) & 0xFF);
+}
+
+/*!
+    @brief  Dump the ring and check it holds the newest events in order.
+    @param  expect
+            Entries the dump should hold.
+    @return true if the dump is exactly the last expect events, oldest
+            first.
+*/
+static bool dumpHoldsNewest(uint32_t expect) {
+  Capture cap;
+  Adafruit_HANOVER_FLIPDOT::dumpTrace(cap);
+  uint32_t n = 0, next = events - expect;
+  const char *p = cap.text.c_str();
+  unsigned long t, ev, a, b;
+  int used;
+  while (sscanf(p, "%lu %lu %lu %lu%n", &t, &ev, &a, &b, &used) == 4) {
+    if ((((ev & 0x7F) << 16) | (b << 8) | a) != (next++ & 0x7FFFFF))
+      return false;
+    n++;
+    p += used;
+  }
+  return n == expect;
+}
+
+int main(void) {
+  check(dumpHoldsNewest(0), "empty ring dumps nothing");
+  record(10);
+  check(dumpHoldsNewest(10), "filling ring dumps every entry");
+  record(RING);
+  check(dumpHoldsNewest(RING), "full ring");
+  record(1000);
+  check(dumpHoldsNewest(RING), "overwritten ring keeps the newest");
+  record(65536 - 5);
+  check(dumpHoldsNewest(RING), "just before the head wraps");
+  record(65536 + 10);
+  check(dumpHoldsNewest(RING), "head wrapped, fewer than a ring since");
+  record(3 * 65536 + 1000);
+  check(dumpHoldsNewest(RING), "head wrapped several times");
+  return errors ? 1 : 0;
+}
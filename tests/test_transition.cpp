@@ -0,0 +1,89 @@
+/*!
+ * @file test_transition.cpp
+ *
+ * HANOVER_FLIPDOT_Transition: every effect ends on the target frame and
+ * pulses each dot that differs exactly once, and no other dot.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+#include "HANOVER_FLIPDOT_Transition.h"
+
+#define W 96                    ///< Panel width
+#define H 16                    ///< Panel height
+#define SIZE (W * ((H + 7) / 8)) ///< Buffer bytes
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Run one effect from one picture to another.
+    @param  effect
+            HANOVER_FLIPDOT_WIPE etc.
+    @param  name
+            Printed on failure.
+    @return None (void).
+*/
+static void run(uint8_t effect, const char *name) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  HANOVER_FLIPDOT_Transition t(&d);
+  check(d.begin(), "begin");
+  uint8_t from[SIZE], to[SIZE];
+  for (uint16_t i = 0; i < SIZE; i++) {
+    from[i] = i * 37;
+    to[i] = i * 11 + 5;
+  }
+  memcpy(d.getBuffer(), from, SIZE);
+  d.display();
+  uint32_t differ = 0;
+  for (uint16_t i = 0; i < SIZE; i++)
+    differ += __builtin_popcount(from[i] ^ to[i]);
+
+  trace.reset();
+  t.begin(effect, 0, to);
+  while (t.step())
+    ;
+  char what[80];
+  bool shows = true;
+  for (uint8_t y = 0; y < H; y++)
+    for (uint8_t x = 0; x < W; x++)
+      shows &= trace.getDot(x, y) == !!(to[x + (y / 8) * W] & (1 << (y & 7)));
+  snprintf(what, sizeof(what), "%s ends on the target frame", name);
+  check(shows && t.done(), what);
+  snprintf(what, sizeof(what), "%s pulses each changed dot once", name);
+  check(trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL] == differ, what);
+  trace.reset();
+  d.display();
+  snprintf(what, sizeof(what), "%s leaves nothing for display()", name);
+  check(trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL] == 0, what);
+}
+
+int main(void) {
+  run(HANOVER_FLIPDOT_WIPE, "wipe");
+  run(HANOVER_FLIPDOT_WIPE_DOWN, "wipe down");
+  run(HANOVER_FLIPDOT_SLIDE, "slide");
+  run(HANOVER_FLIPDOT_DISSOLVE, "dissolve");
+  run(HANOVER_FLIPDOT_CHECKERBOARD, "checkerboard");
+  return errors ? 1 : 0;
+}
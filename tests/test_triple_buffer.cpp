@@ -0,0 +1,95 @@
+/*!
+ * @file test_triple_buffer.cpp
+ *
+ * Stress test of the triple-buffer handoff: a drawing thread commits
+ * frames as fast as it can while a refresh thread shows the latest one.
+ * Every frame carries its number in every column, so a torn frame (two
+ * numbers on the panel at once) or one shown out of order is caught.
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+#include <thread>
+
+#define W 96        ///< Panel width
+#define H 16        ///< Panel height
+#define FRAMES 500  ///< Frames the drawing thread commits
+
+/*!
+    @brief  Read the frame number off the simulated panel.
+    @param  trace
+            Trace decoding the panel.
+    @param  x
+            Column to read.
+    @return Frame number drawn in that column.
+*/
+static uint16_t frameAt(HANOVER_FLIPDOT_VCDTrace &trace, uint8_t x) {
+  uint16_t n = 0;
+  for (uint8_t y = 0; y < H; y++)
+    if (trace.getDot(x, y))
+      n |= 1 << y;
+  return n;
+}
+
+int main(void) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  if (!d.begin() || !d.enableTripleBuffering()) {
+    puts("setup failed");
+    return 1;
+  }
+
+  bool done = false;
+  std::thread draw([&] {
+    for (uint16_t f = 1; f <= FRAMES; f++) {
+      uint8_t *buf = d.getBuffer();
+      for (uint8_t x = 0; x < W; x++) {
+        buf[x] = f & 0xFF;
+        buf[x + W] = f >> 8;
+      }
+      d.commitFrame();
+      for (uint8_t i = 0; i < (f & 7); i++) // Vary the race
+        std::this_thread::yield();
+    }
+    __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+  });
+
+  uint16_t last = 0;
+  uint32_t shown = 0;
+  int errors = 0;
+  for (;;) {
+    bool finished = __atomic_load_n(&done, __ATOMIC_ACQUIRE);
+    if (!d.displayLatest()) {
+      if (finished)
+        break;
+      continue;
+    }
+    shown++;
+    uint16_t f = frameAt(trace, 0);
+    for (uint8_t x = 1; x < W; x++)
+      if (frameAt(trace, x) != f) {
+        printf("torn frame %u: column %u shows %u\n", f, x, frameAt(trace, x));
+        errors++;
+        break;
+      }
+    if (f < last) {
+      printf("frame %u shown after %u\n", f, last);
+      errors++;
+    }
+    last = f;
+  }
+  draw.join();
+
+  if (last != FRAMES) {
+    printf("last frame shown is %u, not %u\n", last, FRAMES);
+    errors++;
+  }
+  printf("%lu of %u frames shown\n", (unsigned long)shown, FRAMES);
+  return errors ? 1 : 0;
+}
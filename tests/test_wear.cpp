@@ -0,0 +1,104 @@
+/*!
+ * @file test_wear.cpp
+ *
+ * Wear counters, per dot and grouped: after a sweep and a run of frames,
+ * getTotalPulses() and the sum of the wear table both equal the coil
+ * pulses the trace saw, and a dot flipped on its own is charged to its
+ * own counter (or its group's) and tops getHottestDots().
+ *
+ * Written by Andrew Littlejohn (Caustic) for LMNC, with
+ * contributions from the open source community.
+ *
+ * BSD license, all text above must be included in any redistribution.
+ *
+ */
+
+#include "Adafruit_HANOVER_FLIPDOT.h"
+#include "HANOVER_FLIPDOT_Trace.h"
+
+#define W 96      ///< Panel width
+#define H 16      ///< Panel height
+#define FLIPS 200 ///< Times the hot dot is flipped
+
+static int errors = 0; ///< Failed checks
+
+/*!
+    @brief  Record a failed check.
+    @param  ok
+            Check result.
+    @param  what
+            Description printed on failure.
+    @return None (void).
+*/
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    errors++;
+  }
+}
+
+/*!
+    @brief  Sum of all wear counters.
+    @param  d
+            Display.
+    @return Total of getWearTable().
+*/
+static uint32_t tableSum(Adafruit_HANOVER_FLIPDOT &d) {
+  uint16_t entries;
+  uint32_t *table = d.getWearTable(&entries), sum = 0;
+  for (uint16_t i = 0; i < entries; i++)
+    sum += table[i];
+  return sum;
+}
+
+/*!
+    @brief  Count wear through a sweep, some frames and one hot dot.
+    @param  grouped
+            Count per 8-dot page column rather than per dot.
+    @return None (void).
+*/
+static void testWear(bool grouped) {
+  Adafruit_HANOVER_FLIPDOT d(W, H, 2, 3, 4, 5, 6, 10, 11, 12, 13);
+  HANOVER_FLIPDOT_VCDTrace trace(&d);
+  check(d.enableWearTracking(grouped), "enableWearTracking");
+  uint16_t entries;
+  d.getWearTable(&entries);
+  check(entries == (grouped ? W * ((H + 7) / 8) : W * H), "table size");
+  check(d.begin(true, 1, true), "begin with sweep");
+
+  for (uint8_t f = 0; f < 10; f++) {
+    d.clearDisplay();
+    d.fillCircle((f * 9) % W, H / 2, 3 + f % 5, HANOVER_FLIPDOT_YELLOW);
+    d.drawLine(0, f, W - 1, H - 1 - f, HANOVER_FLIPDOT_YELLOW);
+    d.display();
+  }
+  uint32_t pulses = trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL];
+  check(d.getTotalPulses() == pulses, "getTotalPulses() matches the trace");
+  check(tableSum(d) == pulses, "wear table adds up to the traced pulses");
+
+  // One dot flipped on its own is charged to its own counter
+  uint8_t x = 37, y = 11;
+  uint32_t before = d.getWear(x, y), other = d.getWear(x + 1, y);
+  for (uint16_t i = 0; i < FLIPS; i++) {
+    d.drawPixel(x, y, HANOVER_FLIPDOT_INVERSE);
+    d.display();
+  }
+  check(d.getWear(x, y) - before == FLIPS, "hot dot counted");
+  check(d.getWear(x + 1, y) == other, "neighbour not charged");
+  check(tableSum(d) == trace.stats().rising[HANOVER_FLIPDOT_TRACE_COIL],
+        "wear table still adds up");
+
+  HANOVER_FLIPDOT_Wear hot[3];
+  check((d.getHottestDots(hot, 3) == 3) && (hot[0].x == x) &&
+            (hot[0].y == (grouped ? (y / 8) * 8 : y)) &&
+            (hot[0].pulses == d.getWear(x, y)) &&
+            (hot[1].pulses <= hot[0].pulses) &&
+            (hot[2].pulses <= hot[1].pulses),
+        "getHottestDots() puts the hot dot first");
+}
+
+int main(void) {
+  testWear(false);
+  testWear(true);
+  return errors ? 1 : 0;
+}